@@ -0,0 +1,22 @@
+#pragma once
+#include <cstddef>
+#include <new>
+
+/**
+ * Tamaño de línea de caché usado para separar datos escritos por hilos
+ * distintos y evitar false sharing.
+ * Usa std::hardware_destructive_interference_size si la librería lo ofrece;
+ * si no, asume 64 bytes (x86-64 y la mayoría de ARM64).
+ */
+#if defined(__cpp_lib_hardware_interference_size)
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Winterference-size"
+#endif
+constexpr std::size_t CACHE_LINE = std::hardware_destructive_interference_size;
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+#else
+constexpr std::size_t CACHE_LINE = 64;
+#endif
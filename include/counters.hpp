@@ -0,0 +1,421 @@
+#pragma once
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include "cacheline.hpp"
+
+/**
+ * Contador particionado (sharded) con una ranura por hilo.
+ * Cada ranura ocupa su propia línea de caché, así los incrementos de hilos
+ * vecinos no comparten línea (sin false sharing).
+ * Cada ranura tiene un único escritor: increment() hace load+store relajados
+ * (sin instrucción lock), y read() puede sumar mientras otros escriben.
+ */
+class ShardedCounter {
+public:
+    explicit ShardedCounter(int slots = 1) : slots_(slots) {}
+
+    // Incrementa la ranura del hilo; solo el dueño de la ranura debe llamarlo
+    void increment(int slot, long delta = 1) {
+        std::atomic<long>& v = slots_[slot].value;
+        v.store(v.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+    }
+
+    // Snapshot: suma de todas las ranuras (exacta si no hay escritores activos)
+    long read() const {
+        long total = 0;
+        for (const Slot& s : slots_) {
+            total += s.value.load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+    // Reinicia todas las ranuras; redimensiona si cambia el número de hilos
+    void reset(int slots) {
+        if (static_cast<std::size_t>(slots) != slots_.size()) {
+            slots_ = std::vector<Slot>(slots);
+        }
+        for (Slot& s : slots_) {
+            s.value.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    int size() const { return static_cast<int>(slots_.size()); }
+
+private:
+    struct alignas(CACHE_LINE) Slot {
+        std::atomic<long> value{0};
+    };
+
+    std::vector<Slot> slots_;
+};
+
+/**
+ * Contador por CPU: una ranura por procesador, elegida con sched_getcpu().
+ * Cada hilo acumula en un delta local (Local) y lo vuelca a la ranura de la
+ * CPU en que corre cada `batch` incrementos, así el número de ranuras no
+ * crece con los hilos (útil con T > núcleos) y el fetch_add es poco frecuente.
+ * read() suma las ranuras: es exacto una vez que cada hilo llamó flush();
+ * mientras hay escritores, puede quedarse corto en a lo sumo T*(batch-1).
+ */
+class PerCpuCounter {
+public:
+    // Delta local de un hilo; vive en la pila del hilo (sin compartir)
+    struct Local {
+        long delta = 0;
+    };
+
+    explicit PerCpuCounter(int cpus = online_cpus(), long batch = 64)
+        : slots_(cpus > 0 ? cpus : 1), batch_(batch > 0 ? batch : 1) {}
+
+    void increment(Local& local) {
+        if (++local.delta >= batch_) {
+            flush(local);
+        }
+    }
+
+    // Vuelca el delta pendiente en la ranura de la CPU actual
+    void flush(Local& local) {
+        if (local.delta == 0) return;
+        int cpu = sched_getcpu();
+        if (cpu < 0) cpu = 0;
+        slots_[cpu % slots_.size()].value.fetch_add(local.delta, std::memory_order_relaxed);
+        local.delta = 0;
+    }
+
+    // Agregación del lado lector: suma de todas las ranuras
+    long read() const {
+        long total = 0;
+        for (const Slot& s : slots_) {
+            total += s.value.load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+    void reset(long batch) {
+        batch_ = batch > 0 ? batch : 1;
+        for (Slot& s : slots_) {
+            s.value.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    long batch() const { return batch_; }
+    int size() const { return static_cast<int>(slots_.size()); }
+
+    static int online_cpus() {
+        long n = sysconf(_SC_NPROCESSORS_CONF);
+        return n > 0 ? static_cast<int>(n) : 1;
+    }
+
+private:
+    struct alignas(CACHE_LINE) Slot {
+        std::atomic<long> value{0};
+    };
+
+    std::vector<Slot> slots_;
+    long batch_;
+};
+
+/**
+ * Contador aproximado ("sloppy") con umbral S.
+ * Cada hilo cuenta en su ranura local y solo empuja al valor global cada S
+ * incrementos, reduciendo el tráfico de coherencia en un factor S.
+ * read() lee solo el global: con T hilos el error es menor que T*S
+ * (cada ranura retiene a lo sumo S-1). read_exact() suma además las ranuras;
+ * es exacto cuando no hay escritores activos.
+ */
+class SloppyCounter {
+public:
+    explicit SloppyCounter(int slots = 1, long threshold = 1024)
+        : slots_(slots), threshold_(threshold > 0 ? threshold : 1) {}
+
+    // Solo el dueño de la ranura debe llamarlo
+    void increment(int slot) {
+        std::atomic<long>& local = slots_[slot].value;
+        long v = local.load(std::memory_order_relaxed) + 1;
+        if (v >= threshold_) {
+            global_.fetch_add(v, std::memory_order_relaxed);
+            v = 0;
+        }
+        local.store(v, std::memory_order_relaxed);
+    }
+
+    // Valor aproximado: error acotado por max_error()
+    long read() const {
+        return global_.load(std::memory_order_relaxed);
+    }
+
+    // Valor exacto en reposo: global más lo retenido en cada ranura
+    long read_exact() const {
+        long total = global_.load(std::memory_order_relaxed);
+        for (const Slot& s : slots_) {
+            total += s.value.load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+    long max_error() const {
+        return static_cast<long>(slots_.size()) * threshold_;
+    }
+
+    void reset(int slots, long threshold) {
+        if (static_cast<std::size_t>(slots) != slots_.size()) {
+            slots_ = std::vector<Slot>(slots);
+        }
+        for (Slot& s : slots_) {
+            s.value.store(0, std::memory_order_relaxed);
+        }
+        global_.store(0, std::memory_order_relaxed);
+        threshold_ = threshold > 0 ? threshold : 1;
+    }
+
+    long threshold() const { return threshold_; }
+
+private:
+    struct alignas(CACHE_LINE) Slot {
+        std::atomic<long> value{0};
+    };
+
+    alignas(CACHE_LINE) std::atomic<long> global_{0};
+    std::vector<Slot> slots_;
+    long threshold_;
+};
+
+/**
+ * Contador con flat combining.
+ * Cada hilo publica su petición en su registro (una línea de caché) y trata
+ * de tomar el lock; quien lo obtiene (el combinador) recorre todos los
+ * registros y aplica en una sola pasada las peticiones pendientes de los
+ * demás. Los que no obtienen el lock esperan a que su registro se marque
+ * como atendido, girando sobre su propia línea en vez de sobre el contador.
+ */
+class FlatCombiningCounter {
+public:
+    explicit FlatCombiningCounter(int slots = 1) : records_(slots) {}
+
+    ~FlatCombiningCounter() {
+        pthread_mutex_destroy(&lock_);
+    }
+
+    FlatCombiningCounter(const FlatCombiningCounter&) = delete;
+    FlatCombiningCounter& operator=(const FlatCombiningCounter&) = delete;
+
+    void increment(int slot, long delta = 1) {
+        Record& rec = records_[slot];
+        rec.delta = delta;
+        rec.pending.store(true, std::memory_order_release);
+        
+        int spins = 0;
+        while (rec.pending.load(std::memory_order_acquire)) {
+            if (pthread_mutex_trylock(&lock_) == 0) {
+                combine();
+                pthread_mutex_unlock(&lock_);
+                return;  // combine() atendió también nuestra petición
+            }
+            if (++spins % 64 == 0) {
+                sched_yield();  // Ceder CPU al combinador (p.ej. con T > núcleos)
+            }
+        }
+    }
+
+    long read() {
+        pthread_mutex_lock(&lock_);
+        long v = value_;
+        pthread_mutex_unlock(&lock_);
+        return v;
+    }
+
+    void reset(int slots) {
+        if (static_cast<std::size_t>(slots) != records_.size()) {
+            records_ = std::vector<Record>(slots);
+        }
+        for (Record& r : records_) {
+            r.pending.store(false, std::memory_order_relaxed);
+        }
+        value_ = 0;
+        passes_ = 0;
+        combined_ = 0;
+    }
+
+    // Peticiones atendidas por pasada de combinación (promedio)
+    double avg_batch() const {
+        return passes_ > 0 ? static_cast<double>(combined_) / passes_ : 0.0;
+    }
+
+private:
+    struct alignas(CACHE_LINE) Record {
+        long delta = 0;
+        std::atomic<bool> pending{false};
+    };
+
+    // Llamar con lock_ tomado
+    void combine() {
+        long applied = 0;
+        for (Record& r : records_) {
+            if (r.pending.load(std::memory_order_acquire)) {
+                value_ += r.delta;
+                r.pending.store(false, std::memory_order_release);
+                applied++;
+            }
+        }
+        passes_++;
+        combined_ += applied;
+    }
+
+    pthread_mutex_t lock_ = PTHREAD_MUTEX_INITIALIZER;
+    std::vector<Record> records_;
+    long value_ = 0;
+    long passes_ = 0;
+    long combined_ = 0;
+};
+
+/**
+ * Árbol de combinación por software (Herlihy & Shavit, cap. 12).
+ * Los hilos suben desde su hoja (dos hilos por hoja); cuando dos se
+ * encuentran en un nodo, uno lleva la suma de ambos hacia la raíz y el otro
+ * espera el resultado. Así la raíz recibe menos operaciones que hilos y la
+ * contención se reparte entre los nodos del árbol.
+ * get_and_increment() retorna el valor previo, como fetch_add.
+ */
+class CombiningTree {
+public:
+    explicit CombiningTree(int threads = 2) { reset(threads); }
+
+    long get_and_increment(int thread_id, long delta = 1) {
+        Node* stack[64];
+        int depth = 0;
+        
+        // Fase 1: precombinar - subir marcando nodos hasta encontrar a otro hilo
+        Node* leaf = &nodes_[leaf_base_ + thread_id / 2];
+        Node* node = leaf;
+        while (node->precombine()) {
+            node = node->parent;
+        }
+        Node* stop = node;
+        
+        // Fase 2: combinar - acumular los valores del camino recorrido
+        node = leaf;
+        long combined = delta;
+        while (node != stop) {
+            combined = node->combine(combined);
+            stack[depth++] = node;
+            node = node->parent;
+        }
+        
+        // Fase 3: operar en el nodo de parada (raíz o espera al compañero)
+        long prior = stop->op(combined);
+        
+        // Fase 4: distribuir resultados hacia abajo
+        while (depth > 0) {
+            stack[--depth]->distribute(prior);
+        }
+        return prior;
+    }
+
+    long read() {
+        Node& root = nodes_[0];
+        pthread_mutex_lock(&root.mutex);
+        long v = root.result;
+        pthread_mutex_unlock(&root.mutex);
+        return v;
+    }
+
+    // Reconstruye el árbol para `threads` hilos (ancho potencia de dos)
+    void reset(int threads) {
+        int width = 2;
+        while (width < threads) width *= 2;
+        int count = width - 1;
+        nodes_.reset(new Node[count]);
+        nodes_[0].status = Node::ROOT;
+        for (int i = 1; i < count; i++) {
+            nodes_[i].parent = &nodes_[(i - 1) / 2];
+        }
+        leaf_base_ = count - width / 2;
+    }
+
+private:
+    struct alignas(CACHE_LINE) Node {
+        enum Status { IDLE, FIRST, SECOND, RESULT, ROOT };
+        
+        pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+        pthread_cond_t cond = PTHREAD_COND_INITIALIZER;
+        Status status = IDLE;
+        bool locked = false;
+        long first_value = 0;
+        long second_value = 0;
+        long result = 0;
+        Node* parent = nullptr;
+
+        ~Node() {
+            pthread_mutex_destroy(&mutex);
+            pthread_cond_destroy(&cond);
+        }
+
+        // Retorna true si el hilo debe seguir subiendo
+        bool precombine() {
+            pthread_mutex_lock(&mutex);
+            while (locked) pthread_cond_wait(&cond, &mutex);
+            bool go_up = false;
+            if (status == IDLE) {
+                status = FIRST;
+                go_up = true;
+            } else if (status == FIRST) {
+                locked = true;  // Segundo hilo: el primero esperará su valor
+                status = SECOND;
+            }
+            pthread_mutex_unlock(&mutex);
+            return go_up;
+        }
+
+        long combine(long combined) {
+            pthread_mutex_lock(&mutex);
+            while (locked) pthread_cond_wait(&cond, &mutex);
+            locked = true;
+            first_value = combined;
+            long out = (status == SECOND) ? first_value + second_value : first_value;
+            pthread_mutex_unlock(&mutex);
+            return out;
+        }
+
+        long op(long combined) {
+            pthread_mutex_lock(&mutex);
+            long prior;
+            if (status == ROOT) {
+                prior = result;
+                result += combined;
+            } else {
+                // SECOND: depositar valor y esperar a que el primero lo distribuya
+                second_value = combined;
+                locked = false;
+                pthread_cond_broadcast(&cond);
+                while (status != RESULT) pthread_cond_wait(&cond, &mutex);
+                locked = false;
+                pthread_cond_broadcast(&cond);
+                status = IDLE;
+                prior = result;
+            }
+            pthread_mutex_unlock(&mutex);
+            return prior;
+        }
+
+        void distribute(long prior) {
+            pthread_mutex_lock(&mutex);
+            if (status == FIRST) {
+                status = IDLE;
+                locked = false;
+            } else if (status == SECOND) {
+                result = prior + first_value;
+                status = RESULT;
+            }
+            pthread_cond_broadcast(&cond);
+            pthread_mutex_unlock(&mutex);
+        }
+    };
+
+    std::unique_ptr<Node[]> nodes_;
+    int leaf_base_ = 0;
+};
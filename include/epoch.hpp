@@ -0,0 +1,127 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "cacheline.hpp"
+
+/**
+ * Recuperación de memoria por épocas (EBR, estilo RCU).
+ * Los lectores recorren estructuras enlazadas sin candados; un nodo
+ * desenlazado no se libera hasta que ningún lector pueda seguir viéndolo.
+ *
+ *   - Cada hilo tiene un registro propio (en su línea de caché) donde
+ *     anuncia la época global vigente al entrar a leer y la borra al salir.
+ *     Leer no escribe ninguna línea compartida.
+ *   - Quien retira un nodo lo guarda en su lista local con la época global
+ *     del momento. Cada RECLAIM_BATCH retiros intenta avanzar la época
+ *     (solo si todos los lectores activos ya están en la vigente) y libera
+ *     lo retirado hace dos o más épocas: ningún lector activo puede tener
+ *     aún una referencia a esos nodos.
+ *
+ * Cada hilo se registra con epoch_attach(domain, id) antes de operar; el
+ * índice de su registro se guarda en una variable thread_local.
+ */
+struct EpochDomain {
+    static constexpr uint64_t ACTIVE = 1;
+    static constexpr std::size_t RECLAIM_BATCH = 64;
+
+    struct Retired {
+        void* ptr;
+        void (*deleter)(void*);
+        uint64_t epoch;
+    };
+
+    struct alignas(CACHE_LINE) Record {
+        std::atomic<uint64_t> state{0};    // (época << 1) | ACTIVE mientras lee; 0 fuera
+        std::vector<Retired> retired;      // Solo lo toca el hilo dueño
+
+        // Estadísticas del hilo dueño
+        long retired_total = 0;
+        long freed_total = 0;
+        std::size_t pending_peak = 0;
+    };
+
+    static inline thread_local std::size_t slot = 0;
+
+    alignas(CACHE_LINE) std::atomic<uint64_t> global{1};
+    std::atomic<long> advances{0};
+    std::vector<Record> records;
+
+    explicit EpochDomain(std::size_t max_threads) : records(max_threads ? max_threads : 1) {}
+    EpochDomain(const EpochDomain&) = delete;
+    EpochDomain& operator=(const EpochDomain&) = delete;
+
+    ~EpochDomain() {
+        for (auto& r : records) {
+            for (auto& item : r.retired) item.deleter(item.ptr);
+        }
+    }
+
+    Record& local() { return records[slot]; }
+
+    // Avanza la época si ningún lector activo sigue en una anterior
+    bool try_advance() {
+        uint64_t e = global.load(std::memory_order_seq_cst);
+        for (auto& r : records) {
+            uint64_t s = r.state.load(std::memory_order_seq_cst);
+            if ((s & ACTIVE) && (s >> 1) != e) return false;
+        }
+        if (global.compare_exchange_strong(e, e + 1, std::memory_order_seq_cst)) {
+            advances.fetch_add(1, std::memory_order_relaxed);
+        }
+        return true;
+    }
+
+    // Libera lo que el hilo retiró hace al menos dos épocas
+    void reclaim(Record& r) {
+        uint64_t g = global.load(std::memory_order_seq_cst);
+        std::size_t n = 0;
+        while (n < r.retired.size() && r.retired[n].epoch + 2 <= g) {
+            r.retired[n].deleter(r.retired[n].ptr);
+            n++;
+        }
+        r.retired.erase(r.retired.begin(), r.retired.begin() + static_cast<std::ptrdiff_t>(n));
+        r.freed_total += static_cast<long>(n);
+    }
+
+    long retired_total() const { long n = 0; for (const auto& r : records) n += r.retired_total; return n; }
+    long freed_total() const { long n = 0; for (const auto& r : records) n += r.freed_total; return n; }
+    std::size_t pending() const { std::size_t n = 0; for (const auto& r : records) n += r.retired.size(); return n; }
+    std::size_t pending_peak() const {
+        std::size_t n = 0;
+        for (const auto& r : records) n = r.pending_peak > n ? r.pending_peak : n;
+        return n;
+    }
+};
+
+inline void epoch_attach(EpochDomain* d, int id) {
+    EpochDomain::slot = static_cast<std::size_t>(id) % d->records.size();
+}
+
+// Entrar a una sección de lectura: anuncia la época vigente
+inline void epoch_enter(EpochDomain* d) {
+    uint64_t e = d->global.load(std::memory_order_seq_cst);
+    d->local().state.store((e << 1) | EpochDomain::ACTIVE, std::memory_order_seq_cst);
+}
+
+inline void epoch_exit(EpochDomain* d) {
+    d->local().state.store(0, std::memory_order_release);
+}
+
+/**
+ * Retirar un nodo ya desenlazado (ningún lector nuevo puede alcanzarlo)
+ * Se libera con delete cuando pasen dos épocas
+ */
+template <class T>
+void epoch_retire(EpochDomain* d, T* node) {
+    auto& r = d->local();
+    r.retired.push_back({node, [](void* p) { delete static_cast<T*>(p); },
+                         d->global.load(std::memory_order_seq_cst)});
+    r.retired_total++;
+    if (r.retired.size() > r.pending_peak) r.pending_peak = r.retired.size();
+    if (r.retired.size() >= EpochDomain::RECLAIM_BATCH) {
+        d->try_advance();
+        d->reclaim(r);
+    }
+}
@@ -0,0 +1,116 @@
+#pragma once
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <atomic>
+#include <cerrno>
+#include <climits>
+#include <cstdint>
+#include <ctime>
+#include "spin.hpp"
+
+/**
+ * Eventcount sobre futex de Linux.
+ * Permite esperar una condición arbitraria sin mutex ni condvar:
+ *
+ *   Esperar:                         Notificar:
+ *     key = ec.prepare_wait();         (hacer verdadera la condición)
+ *     if (cond) ec.cancel_wait();      ec.notify();
+ *     else      ec.wait(key);
+ *
+ * La palabra del futex guarda una época (bits 1..31) y un bit de "hay
+ * esperando" (bit 0). El que espera enciende el bit antes de revisar la
+ * condición; notify() solo hace la syscall FUTEX_WAKE si el bit está
+ * encendido, y al hacerla lo apaga y avanza la época. Así, en régimen
+ * estable notificar cuesta una barrera y una lectura, y mientras un hilo
+ * despertado aún no corre, las notificaciones siguientes no repiten la
+ * syscall. Se despierta a todos los que esperan: cada uno revisa su
+ * condición y, si sigue falsa, vuelve a registrarse.
+ * Si un notify ocurre entre prepare_wait() y wait(), la palabra ya cambió
+ * y FUTEX_WAIT retorna de inmediato (no se pierde el aviso).
+ * wait_until() es igual pero con plazo absoluto en CLOCK_MONOTONIC.
+ */
+class EventCount {
+public:
+    uint32_t prepare_wait() {
+        uint32_t key = state_.fetch_or(WAITERS, std::memory_order_seq_cst) | WAITERS;
+        std::atomic_thread_fence(std::memory_order_seq_cst);  // Antes de revisar la condición
+        return key;
+    }
+
+    // El bit queda encendido: a lo sumo provoca un FUTEX_WAKE de más
+    void cancel_wait() {}
+
+    void wait(uint32_t key) {
+        if (state_.load(std::memory_order_acquire) == key) {
+            waits_.fetch_add(1, std::memory_order_relaxed);
+            syscall(SYS_futex, reinterpret_cast<uint32_t*>(&state_), FUTEX_WAIT_PRIVATE,
+                    key, nullptr, nullptr, 0);
+        }
+    }
+
+    // Retorna false si venció el plazo (deadline_ns en CLOCK_MONOTONIC)
+    bool wait_until(uint32_t key, uint64_t deadline_ns) {
+        if (state_.load(std::memory_order_acquire) != key) return true;
+        timespec ts;
+        ts.tv_sec = static_cast<time_t>(deadline_ns / 1000000000ULL);
+        ts.tv_nsec = static_cast<long>(deadline_ns % 1000000000ULL);
+        waits_.fetch_add(1, std::memory_order_relaxed);
+        // FUTEX_WAIT_BITSET toma el plazo como absoluto en CLOCK_MONOTONIC
+        long rc = syscall(SYS_futex, reinterpret_cast<uint32_t*>(&state_),
+                          FUTEX_WAIT_BITSET_PRIVATE, key, &ts, nullptr, FUTEX_BITSET_MATCH_ANY);
+        return !(rc < 0 && errno == ETIMEDOUT);
+    }
+
+    void notify() {
+        // Ordena la publicación de la condición antes de leer el bit
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        uint32_t s = state_.load(std::memory_order_relaxed);
+        while (s & WAITERS) {
+            if (state_.compare_exchange_weak(s, (s + EPOCH_STEP) & ~WAITERS,
+                                             std::memory_order_seq_cst)) {
+                wakes_.fetch_add(1, std::memory_order_relaxed);
+                syscall(SYS_futex, reinterpret_cast<uint32_t*>(&state_), FUTEX_WAKE_PRIVATE,
+                        INT_MAX, nullptr, nullptr, 0);
+                return;
+            }
+        }
+    }
+
+    /**
+     * Espera hasta que pred() sea verdadero: gira `spins` vueltas y después
+     * se estaciona en el futex. Retorna true si tuvo que dormir.
+     */
+    template <class Pred>
+    bool await(Pred pred, int spins = 128) {
+        for (int i = 0; i < spins; i++) {
+            if (pred()) return false;
+            cpu_relax();
+        }
+        bool parked = false;
+        for (;;) {
+            uint32_t key = prepare_wait();
+            if (pred()) {
+                cancel_wait();
+                return parked;
+            }
+            wait(key);
+            parked = true;
+        }
+    }
+
+    // Syscalls realizadas (solo se cuentan en el camino lento)
+    long wake_syscalls() const { return wakes_.load(std::memory_order_relaxed); }
+    long wait_syscalls() const { return waits_.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr uint32_t WAITERS = 1;
+    static constexpr uint32_t EPOCH_STEP = 2;
+
+    static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t),
+                  "futex requiere un entero de 32 bits");
+
+    std::atomic<uint32_t> state_{0};
+    std::atomic<long> wakes_{0};
+    std::atomic<long> waits_{0};
+};
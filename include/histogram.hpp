@@ -0,0 +1,102 @@
+#pragma once
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+/**
+ * Histograma de latencias con cubetas logarítmicas (estilo HDR).
+ * Valores < 64 se guardan exactos; por encima, cada potencia de dos se
+ * divide en 32 sub-cubetas, así el error relativo es menor a ~3% en todo
+ * el rango (hasta 2^63 ns) con menos de 2000 contadores.
+ * Pensado para uno por hilo (record() sin sincronización) y merge() al final.
+ */
+class LatencyHistogram {
+public:
+    static constexpr int SUB_BITS = 5;
+    static constexpr uint64_t SUB = 1ULL << SUB_BITS;            // 32 sub-cubetas
+    static constexpr uint64_t LINEAR = 2 * SUB;                  // 0..63 exactos
+    static constexpr std::size_t BUCKETS = LINEAR + (64 - SUB_BITS - 1) * SUB;
+
+    LatencyHistogram() : counts_(BUCKETS, 0) {}
+
+    void record(uint64_t value) {
+        counts_[index_of(value)]++;
+        total_++;
+        if (value > max_) max_ = value;
+        sum_ += value;
+    }
+
+    void merge(const LatencyHistogram& other) {
+        for (std::size_t i = 0; i < BUCKETS; i++) {
+            counts_[i] += other.counts_[i];
+        }
+        total_ += other.total_;
+        sum_ += other.sum_;
+        if (other.max_ > max_) max_ = other.max_;
+    }
+
+    // Valor (punto medio de la cubeta) bajo el cual cae el p% de las muestras
+    uint64_t percentile(double p) const {
+        if (total_ == 0) return 0;
+        uint64_t rank = static_cast<uint64_t>(p / 100.0 * total_ + 0.5);
+        if (rank == 0) rank = 1;
+        if (rank > total_) rank = total_;
+        uint64_t seen = 0;
+        for (std::size_t i = 0; i < BUCKETS; i++) {
+            seen += counts_[i];
+            if (seen >= rank) {
+                uint64_t mid = (lower_of(i) + upper_of(i)) / 2;
+                return mid < max_ ? mid : max_;
+            }
+        }
+        return max_;
+    }
+
+    uint64_t count() const { return total_; }
+    uint64_t max() const { return max_; }
+    double mean() const { return total_ ? static_cast<double>(sum_) / total_ : 0.0; }
+
+    /**
+     * Imprime percentiles en microsegundos, una línea por percentil
+     * ("Latencia p99: 12.34 us") para que analyze_results.py pueda graficarlos
+     */
+    void print(const char* label) const {
+        static const double pcts[] = {50.0, 90.0, 99.0, 99.9};
+        static const char* names[] = {"p50", "p90", "p99", "p99.9"};
+        printf("\n=== %s (%llu muestras) ===\n", label,
+               static_cast<unsigned long long>(total_));
+        for (int i = 0; i < 4; i++) {
+            printf("Latencia %s: %.2f us\n", names[i], percentile(pcts[i]) / 1000.0);
+        }
+        printf("Latencia max: %.2f us\n", max_ / 1000.0);
+        printf("Latencia media: %.2f us\n", mean() / 1000.0);
+    }
+
+private:
+    static std::size_t index_of(uint64_t v) {
+        if (v < LINEAR) return static_cast<std::size_t>(v);
+        int msb = 63 - __builtin_clzll(v);
+        int shift = msb - SUB_BITS;
+        uint64_t top = v >> shift;                 // En [SUB, 2*SUB)
+        return LINEAR + (shift - 1) * SUB + (top - SUB);
+    }
+
+    static uint64_t lower_of(std::size_t i) {
+        if (i < LINEAR) return i;
+        int shift = static_cast<int>((i - LINEAR) / SUB) + 1;
+        uint64_t top = (i - LINEAR) % SUB + SUB;
+        return top << shift;
+    }
+
+    static uint64_t upper_of(std::size_t i) {
+        if (i < LINEAR) return i;
+        int shift = static_cast<int>((i - LINEAR) / SUB) + 1;
+        uint64_t top = (i - LINEAR) % SUB + SUB;
+        return ((top + 1) << shift) - 1;
+    }
+
+    std::vector<uint64_t> counts_;
+    uint64_t total_ = 0;
+    uint64_t sum_ = 0;
+    uint64_t max_ = 0;
+};
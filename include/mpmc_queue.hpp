@@ -0,0 +1,211 @@
+#pragma once
+#include <sched.h>
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+#include <cstdint>
+#include "cacheline.hpp"
+#include "eventcount.hpp"
+#include "spin.hpp"
+
+/**
+ * Cola acotada lock-free MPMC con celdas numeradas (esquema de D. Vyukov).
+ * T debe ser copiable trivialmente (int, estructuras POD pequeñas).
+ * Cada celda lleva un número de secuencia que indica de quién es el turno:
+ *   seq == pos       -> libre para el productor con ticket pos
+ *   seq == pos + 1   -> lista para el consumidor con ticket pos
+ * Productores y consumidores solo compiten entre sí por su contador de
+ * tickets (enqueue_pos / dequeue_pos), cada uno en su propia línea de caché.
+ *
+ * Espera adaptativa: con la cola llena/vacía se gira hasta spin_limit
+ * vueltas; si no alcanza se estaciona en un EventCount (futex). spin_limit
+ * se duplica cuando girar tuvo éxito y se reduce a la mitad cuando hubo que
+ * dormir. Quien libera/publica una celda solo hace una syscall si hay hilos
+ * registrados como dormidos.
+ */
+template <std::size_t Capacity, class T = int>
+struct MpmcQueue {
+    using value_type = T;
+    static_assert(std::is_trivially_copyable<T>::value, "T debe ser copiable trivialmente");
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                  "Capacity debe ser potencia de dos");
+    static constexpr std::size_t MASK = Capacity - 1;
+    static constexpr int SPIN_MIN = 16;
+    static constexpr int SPIN_MAX = 4096;
+
+    struct Cell {
+        std::atomic<std::size_t> seq;
+        T data;
+    };
+
+    alignas(CACHE_LINE) std::atomic<std::size_t> enqueue_pos{0};
+    alignas(CACHE_LINE) std::atomic<std::size_t> dequeue_pos{0};
+
+    // Estado de espera: solo se toca en el camino lento
+    alignas(CACHE_LINE) std::atomic<bool> stop{false};
+    std::atomic<int> spin_limit{256};
+    alignas(CACHE_LINE) EventCount not_full;
+    alignas(CACHE_LINE) EventCount not_empty;
+
+    // Estadísticas
+    std::atomic<long> wait_full{0};    // Veces que un productor encontró la cola llena
+    std::atomic<long> wait_empty{0};   // Veces que un consumidor encontró la cola vacía
+    std::atomic<long> park_full{0};    // ... y tuvo que dormir
+    std::atomic<long> park_empty{0};
+
+    alignas(CACHE_LINE) Cell cells[Capacity];
+
+    MpmcQueue() {
+        for (std::size_t i = 0; i < Capacity; i++) {
+            cells[i].seq.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    bool try_push(const T& value) {
+        std::size_t pos = enqueue_pos.load(std::memory_order_relaxed);
+        Cell* cell;
+        for (;;) {
+            cell = &cells[pos & MASK];
+            std::size_t seq = cell->seq.load(std::memory_order_acquire);
+            intptr_t dif = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (dif == 0) {
+                if (enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (dif < 0) {
+                return false;  // Llena
+            } else {
+                pos = enqueue_pos.load(std::memory_order_relaxed);
+            }
+        }
+        cell->data = value;
+        cell->seq.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool try_pop(T* output) {
+        std::size_t pos = dequeue_pos.load(std::memory_order_relaxed);
+        Cell* cell;
+        for (;;) {
+            cell = &cells[pos & MASK];
+            std::size_t seq = cell->seq.load(std::memory_order_acquire);
+            intptr_t dif = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+            if (dif == 0) {
+                if (dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (dif < 0) {
+                return false;  // Vacía
+            } else {
+                pos = dequeue_pos.load(std::memory_order_relaxed);
+            }
+        }
+        *output = cell->data;
+        cell->seq.store(pos + Capacity, std::memory_order_release);
+        return true;
+    }
+
+    bool full() const {
+        std::size_t pos = enqueue_pos.load(std::memory_order_relaxed);
+        std::size_t seq = cells[pos & MASK].seq.load(std::memory_order_acquire);
+        return static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos) < 0;
+    }
+
+    bool empty() const {
+        std::size_t pos = dequeue_pos.load(std::memory_order_relaxed);
+        std::size_t seq = cells[pos & MASK].seq.load(std::memory_order_acquire);
+        return static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1) < 0;
+    }
+
+    void adapt(bool spin_succeeded) {
+        int limit = spin_limit.load(std::memory_order_relaxed);
+        if (spin_succeeded && limit < SPIN_MAX) {
+            spin_limit.store(limit * 2, std::memory_order_relaxed);
+        } else if (!spin_succeeded && limit > SPIN_MIN) {
+            spin_limit.store(limit / 2, std::memory_order_relaxed);
+        }
+    }
+};
+
+/**
+ * Insertar elemento (cualquier productor)
+ * Gira y luego duerme mientras la cola está llena
+ */
+template <std::size_t N, class T>
+void ring_push(MpmcQueue<N, T>* q, T value) {
+    if (!q->try_push(value)) {
+        q->wait_full.fetch_add(1, std::memory_order_relaxed);
+
+        // Fase 1: giro adaptativo
+        int limit = q->spin_limit.load(std::memory_order_relaxed);
+        bool pushed = false;
+        for (int i = 0; i < limit && !pushed; i++) {
+            if (q->stop.load(std::memory_order_acquire)) return;
+            cpu_relax();
+            if (i % 32 == 31) sched_yield();
+            pushed = q->try_push(value);
+        }
+        q->adapt(pushed);
+
+        // Fase 2: dormir en el futex hasta que un consumidor libere una celda
+        while (!pushed) {
+            bool parked = q->not_full.await([q] {
+                return !q->full() || q->stop.load(std::memory_order_acquire);
+            }, 0);
+            if (parked) q->park_full.fetch_add(1, std::memory_order_relaxed);
+
+            if (q->stop.load(std::memory_order_acquire)) return;
+            pushed = q->try_push(value);
+        }
+    }
+    q->not_empty.notify();  // Sin syscall si no hay consumidores dormidos
+}
+
+/**
+ * Extraer elemento (cualquier consumidor)
+ * Retorna false si la cola está vacía y se activó stop
+ */
+template <std::size_t N, class T>
+bool ring_pop(MpmcQueue<N, T>* q, T* output) {
+    if (!q->try_pop(output)) {
+        q->wait_empty.fetch_add(1, std::memory_order_relaxed);
+
+        // Fase 1: giro adaptativo
+        int limit = q->spin_limit.load(std::memory_order_relaxed);
+        bool popped = false;
+        for (int i = 0; i < limit && !popped; i++) {
+            if (q->stop.load(std::memory_order_acquire)) break;
+            cpu_relax();
+            if (i % 32 == 31) sched_yield();
+            popped = q->try_pop(output);
+        }
+        if (!q->stop.load(std::memory_order_acquire)) q->adapt(popped);
+
+        // Fase 2: dormir en el futex hasta que un productor publique una celda
+        while (!popped) {
+            bool parked = q->not_empty.await([q] {
+                return !q->empty() || q->stop.load(std::memory_order_acquire);
+            }, 0);
+            if (parked) q->park_empty.fetch_add(1, std::memory_order_relaxed);
+
+            popped = q->try_pop(output);
+            if (!popped && q->stop.load(std::memory_order_acquire)) {
+                // Releer tras stop: puede quedar un elemento publicado antes
+                popped = q->try_pop(output);
+                if (!popped) return false;
+            }
+        }
+    }
+    q->not_full.notify();  // Sin syscall si no hay productores dormidos
+    return true;
+}
+
+template <std::size_t N, class T>
+void ring_shutdown(MpmcQueue<N, T>* q) {
+    q->stop.store(true, std::memory_order_release);
+    q->not_full.notify();
+    q->not_empty.notify();
+}
+
+template <std::size_t N, class T>
+void ring_destroy(MpmcQueue<N, T>*) {}
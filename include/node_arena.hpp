@@ -0,0 +1,161 @@
+#pragma once
+#include <pthread.h>
+#include <sys/mman.h>
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+/**
+ * Arena de nodos de tamaño fijo (slab) para una sola estructura.
+ * Pide bloques de ChunkItems nodos con mmap y los reparte por lotes a
+ * cachés por hilo (NodeCache); el mutex de la arena solo se toma al
+ * rellenar o vaciar una caché, una vez cada BATCH nodos.
+ *
+ * Los nodos no se destruyen uno a uno: release() devuelve todos los bloques
+ * al sistema de una vez, por eso T debe ser trivialmente destructible.
+ *
+ * Uso:
+ *   NodeArena<Node> arena;
+ *   NodeCache<Node> cache(&arena);      // una por hilo
+ *   Node* n = new (cache.alloc()) Node(k, v);
+ *   cache.free(n);                      // opcional: vuelve a la caché local
+ *   arena.release();                    // sin hilos operando
+ */
+template <class T, std::size_t ChunkItems = 4096>
+struct NodeArena {
+    static_assert(std::is_trivially_destructible<T>::value, "T debe ser trivialmente destructible");
+    static_assert(sizeof(T) >= sizeof(void*), "T debe poder guardar un puntero de la lista libre");
+    static constexpr std::size_t BATCH = 64;   // Nodos por relleno de una caché
+
+    pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+    std::vector<T*> chunks;
+    T* bump = nullptr;            // Próximo nodo sin usar del bloque actual
+    T* bump_end = nullptr;
+    T* free_list = nullptr;       // Nodos devueltos por cachés que terminaron
+
+    // Estadísticas (protegidas por mutex)
+    long refills = 0;
+    long nodes_handed = 0;
+
+    NodeArena() = default;
+    NodeArena(const NodeArena&) = delete;
+    NodeArena& operator=(const NodeArena&) = delete;
+
+    ~NodeArena() {
+        release();
+        pthread_mutex_destroy(&mutex);
+    }
+
+    static T* next_of(T* node) {
+        T* next;
+        std::memcpy(&next, static_cast<void*>(node), sizeof(next));
+        return next;
+    }
+
+    static void set_next(T* node, T* next) {
+        std::memcpy(static_cast<void*>(node), &next, sizeof(next));
+    }
+
+    /**
+     * Entrega hasta `max` nodos enlazados como lista libre (primer nodo)
+     * Reutiliza nodos devueltos antes de cortar del bloque actual
+     */
+    T* refill(std::size_t max, std::size_t* got) {
+        pthread_mutex_lock(&mutex);
+        T* head = nullptr;
+        std::size_t n = 0;
+        while (n < max && free_list) {
+            T* node = free_list;
+            free_list = next_of(node);
+            set_next(node, head);
+            head = node;
+            n++;
+        }
+        while (n < max) {
+            if (bump == bump_end) {
+                void* mem = mmap(nullptr, ChunkItems * sizeof(T), PROT_READ | PROT_WRITE,
+                                 MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+                if (mem == MAP_FAILED) {
+                    pthread_mutex_unlock(&mutex);
+                    throw std::bad_alloc();
+                }
+                bump = static_cast<T*>(mem);
+                bump_end = bump + ChunkItems;
+                chunks.push_back(bump);
+            }
+            T* node = bump++;
+            set_next(node, head);
+            head = node;
+            n++;
+        }
+        refills++;
+        nodes_handed += static_cast<long>(n);
+        pthread_mutex_unlock(&mutex);
+        *got = n;
+        return head;
+    }
+
+    // Recibe la lista libre de una caché (de `tail` hacia atrás hasta head)
+    void give_back(T* head, T* tail) {
+        pthread_mutex_lock(&mutex);
+        set_next(tail, free_list);
+        free_list = head;
+        pthread_mutex_unlock(&mutex);
+    }
+
+    // Libera todos los bloques; no debe haber hilos ni cachés operando
+    void release() {
+        for (T* chunk : chunks) {
+            munmap(chunk, ChunkItems * sizeof(T));
+        }
+        chunks.clear();
+        bump = bump_end = free_list = nullptr;
+    }
+
+    std::size_t bytes() const { return chunks.size() * ChunkItems * sizeof(T); }
+};
+
+/**
+ * Caché de nodos local a un hilo (cada hilo crea la suya).
+ * alloc/free solo tocan la lista libre propia: sin atómicos ni candados
+ * salvo al rellenar desde la arena. Al destruirse devuelve a la arena los
+ * nodos que no usó.
+ */
+template <class T, std::size_t ChunkItems = 4096>
+struct NodeCache {
+    using Arena = NodeArena<T, ChunkItems>;
+
+    Arena* arena;
+    T* free_list = nullptr;
+    std::size_t free_count = 0;
+
+    explicit NodeCache(Arena* a) : arena(a) {}
+    NodeCache(const NodeCache&) = delete;
+    NodeCache& operator=(const NodeCache&) = delete;
+
+    ~NodeCache() {
+        if (!free_list) return;
+        T* tail = free_list;
+        while (Arena::next_of(tail)) tail = Arena::next_of(tail);
+        arena->give_back(free_list, tail);
+    }
+
+    // Memoria sin construir para un T (construir con placement new)
+    T* alloc() {
+        if (!free_list) {
+            free_list = arena->refill(Arena::BATCH, &free_count);
+        }
+        T* node = free_list;
+        free_list = Arena::next_of(node);
+        free_count--;
+        return node;
+    }
+
+    void free(T* node) {
+        Arena::set_next(node, free_list);
+        free_list = node;
+        free_count++;
+    }
+};
@@ -0,0 +1,181 @@
+#pragma once
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+/**
+ * Contadores de hardware/software vía perf_event_open.
+ * Mide ciclos, instrucciones, fallos de LLC, cambios de contexto y
+ * migraciones de una región. Es opcional: solo se activa con la variable de
+ * entorno LAB6_PERF=1. Si el kernel no permite algún evento (contenedores,
+ * perf_event_paranoid alto, VMs sin PMU) ese valor se reporta como "n/d"
+ * y el benchmark sigue normalmente.
+ *
+ * Uso:
+ *   PerfScope perf(true);   // true: incluye hilos creados dentro de la región
+ *   ... región medida ...
+ *   perf.stop();
+ *   perf.print();
+ */
+
+enum PerfEvent {
+    PERF_CYCLES = 0,
+    PERF_INSTRUCTIONS,
+    PERF_LLC_MISSES,
+    PERF_CTX_SWITCHES,
+    PERF_MIGRATIONS,
+    PERF_NUM_EVENTS
+};
+
+inline bool perf_enabled() {
+    static const bool enabled = [] {
+        const char* env = std::getenv("LAB6_PERF");
+        return env && env[0] != '\0' && env[0] != '0';
+    }();
+    return enabled;
+}
+
+class PerfScope {
+public:
+    /**
+     * inherit = true cuenta también los hilos creados después de abrir los
+     * contadores (se suman al terminar cada hilo, por eso stop() debe
+     * llamarse después de pthread_join). Con false mide solo el hilo actual.
+     */
+    explicit PerfScope(bool inherit = true) {
+        for (int i = 0; i < PERF_NUM_EVENTS; i++) {
+            fds_[i] = -1;
+            values_[i] = 0;
+        }
+        if (!perf_enabled()) return;
+
+        for (int i = 0; i < PERF_NUM_EVENTS; i++) {
+            fds_[i] = open_event(static_cast<PerfEvent>(i), inherit);
+        }
+        for (int i = 0; i < PERF_NUM_EVENTS; i++) {
+            if (fds_[i] >= 0) {
+                ioctl(fds_[i], PERF_EVENT_IOC_RESET, 0);
+                ioctl(fds_[i], PERF_EVENT_IOC_ENABLE, 0);
+            }
+        }
+    }
+
+    ~PerfScope() {
+        for (int i = 0; i < PERF_NUM_EVENTS; i++) {
+            if (fds_[i] >= 0) close(fds_[i]);
+        }
+    }
+
+    PerfScope(const PerfScope&) = delete;
+    PerfScope& operator=(const PerfScope&) = delete;
+
+    // Detiene la medición y guarda los valores (escalados si hubo multiplexado)
+    void stop() {
+        if (stopped_) return;
+        stopped_ = true;
+        for (int i = 0; i < PERF_NUM_EVENTS; i++) {
+            if (fds_[i] < 0) continue;
+            ioctl(fds_[i], PERF_EVENT_IOC_DISABLE, 0);
+
+            uint64_t data[3] = {0, 0, 0};  // valor, tiempo habilitado, tiempo corriendo
+            if (read(fds_[i], data, sizeof(data)) != sizeof(data)) {
+                close(fds_[i]);
+                fds_[i] = -1;
+                continue;
+            }
+            double scale = (data[2] > 0 && data[2] < data[1])
+                           ? static_cast<double>(data[1]) / data[2] : 1.0;
+            values_[i] = static_cast<long long>(data[0] * scale);
+        }
+    }
+
+    bool available(PerfEvent e) const { return fds_[e] >= 0; }
+    long long value(PerfEvent e) const { return values_[e]; }
+
+    // Imprime una línea con los contadores; no imprime nada si está desactivado
+    void print(const char* label = "Perf") {
+        if (!perf_enabled()) return;
+        stop();
+
+        bool any = false;
+        for (int i = 0; i < PERF_NUM_EVENTS; i++) {
+            any = any || fds_[i] >= 0;
+        }
+        if (!any) {
+            printf("%s: perf_event_open no disponible (%s)\n", label, strerror(open_errno_));
+            return;
+        }
+
+        static const char* names[PERF_NUM_EVENTS] = {
+            "ciclos", "instrucciones", "LLC-misses", "cambios-contexto", "migraciones"
+        };
+        printf("%s:", label);
+        for (int i = 0; i < PERF_NUM_EVENTS; i++) {
+            if (fds_[i] >= 0) {
+                printf(" %s=%lld", names[i], values_[i]);
+            } else {
+                printf(" %s=n/d", names[i]);
+            }
+        }
+        if (available(PERF_CYCLES) && available(PERF_INSTRUCTIONS) && values_[PERF_CYCLES] > 0) {
+            printf(" IPC=%.2f", static_cast<double>(values_[PERF_INSTRUCTIONS]) / values_[PERF_CYCLES]);
+        }
+        printf("\n");
+    }
+
+private:
+    int open_event(PerfEvent e, bool inherit) {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.disabled = 1;
+        attr.inherit = inherit ? 1 : 0;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        switch (e) {
+            case PERF_CYCLES:
+                attr.type = PERF_TYPE_HARDWARE;
+                attr.config = PERF_COUNT_HW_CPU_CYCLES;
+                break;
+            case PERF_INSTRUCTIONS:
+                attr.type = PERF_TYPE_HARDWARE;
+                attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+                break;
+            case PERF_LLC_MISSES:
+                attr.type = PERF_TYPE_HARDWARE;
+                attr.config = PERF_COUNT_HW_CACHE_MISSES;
+                break;
+            case PERF_CTX_SWITCHES:
+                attr.type = PERF_TYPE_SOFTWARE;
+                attr.config = PERF_COUNT_SW_CONTEXT_SWITCHES;
+                break;
+            case PERF_MIGRATIONS:
+                attr.type = PERF_TYPE_SOFTWARE;
+                attr.config = PERF_COUNT_SW_CPU_MIGRATIONS;
+                break;
+            default:
+                return -1;
+        }
+
+        // Primero con kernel incluido; si paranoid lo impide, solo espacio de usuario
+        int fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+        if (fd < 0 && (errno == EACCES || errno == EPERM)) {
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+        }
+        if (fd < 0) open_errno_ = errno;
+        return fd;
+    }
+
+    int fds_[PERF_NUM_EVENTS];
+    long long values_[PERF_NUM_EVENTS];
+    int open_errno_ = 0;
+    bool stopped_ = false;
+};
@@ -0,0 +1,242 @@
+#pragma once
+#include <pthread.h>
+#include <sys/mman.h>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <new>
+#include <type_traits>
+#include "timing.hpp"
+
+/**
+ * Cola FIFO no acotada de segmentos enlazados, protegida con mutex + condvar.
+ * T debe ser copiable trivialmente (int, estructuras POD pequeñas).
+ * ring_push nunca bloquea: cuando el segmento de escritura se llena se
+ * enlaza otro. Los segmentos vacíos no se liberan de inmediato: vuelven a
+ * un pool (lista libre) y el siguiente crecimiento los reutiliza, así en
+ * régimen estable no hay reservas de memoria.
+ *
+ * Devolución de memoria: el pool recuerda cuántos segmentos tuvo como
+ * mínimo durante cada ventana de idle_ms; esos no se usaron en toda la
+ * ventana y se liberan al cerrarla (marca de agua baja). La ventana se
+ * revisa al liberar un segmento y cada vez que un consumidor despierta;
+ * los consumidores dormidos despiertan cada idle_ms aunque no haya
+ * tráfico, así con la cola inactiva el pool se vacía en una o dos
+ * ventanas. idle_ms = 0 desactiva el pool (libera cada segmento al vaciarse).
+ *
+ * Los segmentos se piden con mmap y se liberan con munmap para que la
+ * memoria regrese al sistema (malloc podría retenerla en su heap).
+ */
+template <class T, std::size_t SegmentItems = 4096>
+struct SegmentedQueue {
+    using value_type = T;
+    static_assert(std::is_trivially_copyable<T>::value, "T debe ser copiable trivialmente");
+    static_assert(SegmentItems > 0, "SegmentItems debe ser positivo");
+
+    struct Segment {
+        Segment* next = nullptr;
+        std::size_t read = 0;      // Próxima posición a extraer
+        std::size_t write = 0;     // Próxima posición a escribir
+        T items[SegmentItems];
+    };
+
+    Segment* head_seg = nullptr;   // Segmento de lectura
+    Segment* tail_seg = nullptr;   // Segmento de escritura
+    std::size_t count = 0;
+    bool stop = false;
+
+    // Pool de segmentos libres (pila)
+    Segment* pool = nullptr;
+    std::size_t pool_size = 0;
+    std::size_t pool_min = 0;      // Mínimo del pool en la ventana actual
+    uint64_t window_start_ns = 0;
+    uint64_t idle_ns;
+
+    pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+    pthread_cond_t not_empty;
+
+    // Estadísticas (protegidas por mutex)
+    long total_produced = 0;
+    long total_consumed = 0;
+    long wait_full = 0;            // Siempre 0: push no bloquea
+    long wait_empty = 0;
+    long segments_mapped = 0;      // mmap realizados
+    long segments_reused = 0;      // Segmentos tomados del pool
+    long segments_unmapped = 0;    // munmap realizados
+    std::size_t segments_live = 0; // En la cola + en el pool
+    std::size_t segments_peak = 0;
+
+    explicit SegmentedQueue(unsigned idle_ms = 200)
+        : idle_ns(static_cast<uint64_t>(idle_ms) * 1000000ULL) {
+        pthread_condattr_t attr;
+        pthread_condattr_init(&attr);
+        pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+        pthread_cond_init(&not_empty, &attr);
+        pthread_condattr_destroy(&attr);
+
+        window_start_ns = now_ns();
+        head_seg = tail_seg = acquire_segment();
+    }
+
+    SegmentedQueue(const SegmentedQueue&) = delete;
+    SegmentedQueue& operator=(const SegmentedQueue&) = delete;
+
+    static constexpr std::size_t segment_bytes() { return sizeof(Segment); }
+
+    // Las funciones siguientes requieren tener el mutex
+
+    Segment* acquire_segment() {
+        Segment* s;
+        if (pool) {
+            s = pool;
+            pool = s->next;
+            pool_size--;
+            if (pool_size < pool_min) pool_min = pool_size;
+            segments_reused++;
+        } else {
+            void* mem = mmap(nullptr, sizeof(Segment), PROT_READ | PROT_WRITE,
+                             MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (mem == MAP_FAILED) throw std::bad_alloc();
+            s = static_cast<Segment*>(mem);
+            segments_mapped++;
+            segments_live++;
+            if (segments_live > segments_peak) segments_peak = segments_live;
+        }
+        s->next = nullptr;
+        s->read = 0;
+        s->write = 0;
+        return s;
+    }
+
+    void unmap_segment(Segment* s) {
+        munmap(s, sizeof(Segment));
+        segments_unmapped++;
+        segments_live--;
+    }
+
+    void release_segment(Segment* s) {
+        if (idle_ns == 0) {
+            unmap_segment(s);
+            return;
+        }
+        s->next = pool;
+        pool = s;
+        pool_size++;
+    }
+
+    // Cierra la ventana si ya pasó idle_ns: libera lo que no se usó en ella
+    void maybe_trim(uint64_t now) {
+        if (now - window_start_ns < idle_ns) return;
+        for (; pool_min > 0 && pool; pool_min--) {
+            Segment* s = pool;
+            pool = s->next;
+            pool_size--;
+            unmap_segment(s);
+        }
+        pool_min = pool_size;
+        window_start_ns = now;
+    }
+};
+
+/**
+ * Insertar elemento (cualquier productor)
+ * No bloquea: si el segmento de escritura está lleno se enlaza otro
+ */
+template <class T, std::size_t N>
+void ring_push(SegmentedQueue<T, N>* q, T value) {
+    pthread_mutex_lock(&q->mutex);
+    if (q->stop) {
+        pthread_mutex_unlock(&q->mutex);
+        return;
+    }
+
+    auto* seg = q->tail_seg;
+    if (seg->write == N) {
+        seg = q->acquire_segment();
+        q->tail_seg->next = seg;
+        q->tail_seg = seg;
+    }
+    seg->items[seg->write++] = value;
+    q->count++;
+    q->total_produced++;
+
+    pthread_cond_signal(&q->not_empty);
+    pthread_mutex_unlock(&q->mutex);
+}
+
+/**
+ * Extraer elemento (cualquier consumidor)
+ * Retorna false si la cola está vacía y se activó stop
+ */
+template <class T, std::size_t N>
+bool ring_pop(SegmentedQueue<T, N>* q, T* output) {
+    pthread_mutex_lock(&q->mutex);
+
+    while (q->count == 0 && !q->stop) {
+        q->wait_empty++;
+        if (q->idle_ns == 0) {
+            pthread_cond_wait(&q->not_empty, &q->mutex);
+            continue;
+        }
+        // Espera acotada: sin tráfico también hay que cerrar ventanas del pool
+        uint64_t deadline = now_ns() + q->idle_ns;
+        timespec ts;
+        ts.tv_sec = static_cast<time_t>(deadline / 1000000000ULL);
+        ts.tv_nsec = static_cast<long>(deadline % 1000000000ULL);
+        pthread_cond_timedwait(&q->not_empty, &q->mutex, &ts);
+        q->maybe_trim(now_ns());
+    }
+
+    if (q->count == 0) {
+        pthread_mutex_unlock(&q->mutex);
+        return false;
+    }
+
+    auto* seg = q->head_seg;
+    if (seg->read == N) {
+        // Segmento agotado: avanzar y devolverlo al pool
+        q->head_seg = seg->next;
+        q->release_segment(seg);
+        seg = q->head_seg;
+        if (q->idle_ns > 0) q->maybe_trim(now_ns());
+    }
+    *output = seg->items[seg->read++];
+    q->count--;
+    q->total_consumed++;
+
+    // Cola vacía en un único segmento: reiniciar índices en lugar de enlazar otro
+    if (q->count == 0 && seg == q->tail_seg) {
+        seg->read = 0;
+        seg->write = 0;
+    }
+
+    pthread_mutex_unlock(&q->mutex);
+    return true;
+}
+
+template <class T, std::size_t N>
+void ring_shutdown(SegmentedQueue<T, N>* q) {
+    pthread_mutex_lock(&q->mutex);
+    q->stop = true;
+    pthread_cond_broadcast(&q->not_empty);
+    pthread_mutex_unlock(&q->mutex);
+}
+
+// Libera todos los segmentos (cola y pool); no debe haber hilos operando
+template <class T, std::size_t N>
+void ring_destroy(SegmentedQueue<T, N>* q) {
+    for (auto* s = q->head_seg; s;) {
+        auto* next = s->next;
+        q->unmap_segment(s);
+        s = next;
+    }
+    for (auto* s = q->pool; s;) {
+        auto* next = s->next;
+        q->unmap_segment(s);
+        s = next;
+    }
+    q->head_seg = q->tail_seg = q->pool = nullptr;
+    q->pool_size = q->pool_min = 0;
+    pthread_mutex_destroy(&q->mutex);
+    pthread_cond_destroy(&q->not_empty);
+}
@@ -0,0 +1,222 @@
+#pragma once
+#include <pthread.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <type_traits>
+
+/**
+ * Cola circular acotada en memoria compartida entre procesos.
+ * Misma semántica que Ring (mutex + condvars, push bloquea con cola llena,
+ * pop retorna false tras ring_shutdown), pero toda la estructura vive en
+ * una región memfd y el mutex/condvars usan PTHREAD_PROCESS_SHARED, así
+ * otro proceso puede mapear la región y operar sobre la misma cola.
+ *
+ * Uso:
+ *   int fd;
+ *   auto* r = shm_ring_create<T>("nombre", &fd);   // proceso creador
+ *   ... fork() / pasar fd (SCM_RIGHTS) / abrir /proc/<pid>/fd/<fd> ...
+ *   auto* r2 = shm_ring_attach<T>(fd);            // otro proceso
+ *   ring_push(r2, v);
+ *   shm_ring_detach(r2);                          // cada proceso
+ *   shm_ring_destroy(r, fd);                      // creador, al final
+ *
+ * Solo guarda tipos copiables trivialmente (sin punteros válidos entre
+ * procesos). El mutex es robusto: si un proceso muere con el lock tomado,
+ * el siguiente que lo pida lo recupera en lugar de bloquearse para siempre.
+ */
+template <class T, std::size_t Capacity = 1024>
+struct ShmRing {
+    using value_type = T;
+    static_assert(std::is_trivially_copyable<T>::value, "T debe ser copiable trivialmente");
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0,
+                  "Capacity debe ser potencia de dos");
+    static constexpr std::size_t MASK = Capacity - 1;
+    static constexpr uint32_t MAGIC = 0x4c365348;   // "L6SH"
+
+    // Cabecera para validar al adjuntar
+    uint32_t magic;
+    uint32_t elem_size;
+    uint64_t capacity;
+
+    pthread_mutex_t mutex;
+    pthread_cond_t not_full;
+    pthread_cond_t not_empty;
+
+    std::size_t head;
+    std::size_t tail;
+    std::size_t count;
+    bool stop;
+
+    // Estadísticas (protegidas por mutex)
+    long total_produced;
+    long total_consumed;
+    long wait_full;
+    long wait_empty;
+    long owner_died;       // Veces que se recuperó el mutex de un proceso muerto
+
+    T buf[Capacity];
+};
+
+// Toma el mutex; si el dueño anterior murió, marca el estado como consistente
+template <class T, std::size_t N>
+void shm_ring_lock(ShmRing<T, N>* r) {
+    if (pthread_mutex_lock(&r->mutex) == EOWNERDEAD) {
+        r->owner_died++;
+        pthread_mutex_consistent(&r->mutex);
+    }
+}
+
+// Espera en una condvar; al despertar puede recibir el mutex de un proceso muerto
+template <class T, std::size_t N>
+void shm_ring_wait(ShmRing<T, N>* r, pthread_cond_t* cond) {
+    if (pthread_cond_wait(cond, &r->mutex) == EOWNERDEAD) {
+        r->owner_died++;
+        pthread_mutex_consistent(&r->mutex);
+    }
+}
+
+/**
+ * Crea la región (memfd) e inicializa la cola
+ * Retorna nullptr si falla; *fd_out queda abierto para compartirlo
+ */
+template <class T, std::size_t N = 1024>
+ShmRing<T, N>* shm_ring_create(const char* name, int* fd_out) {
+    int fd = memfd_create(name, 0);
+    if (fd < 0) {
+        fprintf(stderr, "memfd_create: %s\n", strerror(errno));
+        return nullptr;
+    }
+    if (ftruncate(fd, sizeof(ShmRing<T, N>)) != 0) {
+        fprintf(stderr, "ftruncate: %s\n", strerror(errno));
+        close(fd);
+        return nullptr;
+    }
+    void* mem = mmap(nullptr, sizeof(ShmRing<T, N>), PROT_READ | PROT_WRITE,
+                     MAP_SHARED, fd, 0);
+    if (mem == MAP_FAILED) {
+        fprintf(stderr, "mmap: %s\n", strerror(errno));
+        close(fd);
+        return nullptr;
+    }
+
+    auto* r = static_cast<ShmRing<T, N>*>(mem);   // memfd nuevo: ya está en cero
+
+    pthread_mutexattr_t mattr;
+    pthread_mutexattr_init(&mattr);
+    pthread_mutexattr_setpshared(&mattr, PTHREAD_PROCESS_SHARED);
+    pthread_mutexattr_setrobust(&mattr, PTHREAD_MUTEX_ROBUST);
+    pthread_mutex_init(&r->mutex, &mattr);
+    pthread_mutexattr_destroy(&mattr);
+
+    pthread_condattr_t cattr;
+    pthread_condattr_init(&cattr);
+    pthread_condattr_setpshared(&cattr, PTHREAD_PROCESS_SHARED);
+    pthread_condattr_setclock(&cattr, CLOCK_MONOTONIC);
+    pthread_cond_init(&r->not_full, &cattr);
+    pthread_cond_init(&r->not_empty, &cattr);
+    pthread_condattr_destroy(&cattr);
+
+    r->elem_size = sizeof(T);
+    r->capacity = N;
+    __atomic_store_n(&r->magic, ShmRing<T, N>::MAGIC, __ATOMIC_RELEASE);  // Lista para adjuntar
+
+    *fd_out = fd;
+    return r;
+}
+
+/**
+ * Mapea una cola ya creada desde su descriptor (en otro proceso)
+ * Retorna nullptr si la región no es una ShmRing<T, N>
+ */
+template <class T, std::size_t N = 1024>
+ShmRing<T, N>* shm_ring_attach(int fd) {
+    void* mem = mmap(nullptr, sizeof(ShmRing<T, N>), PROT_READ | PROT_WRITE,
+                     MAP_SHARED, fd, 0);
+    if (mem == MAP_FAILED) {
+        fprintf(stderr, "mmap: %s\n", strerror(errno));
+        return nullptr;
+    }
+    auto* r = static_cast<ShmRing<T, N>*>(mem);
+    if (__atomic_load_n(&r->magic, __ATOMIC_ACQUIRE) != ShmRing<T, N>::MAGIC ||
+        r->elem_size != sizeof(T) || r->capacity != N) {
+        fprintf(stderr, "shm_ring_attach: la región no coincide con ShmRing<T, %zu>\n", N);
+        munmap(mem, sizeof(ShmRing<T, N>));
+        return nullptr;
+    }
+    return r;
+}
+
+template <class T, std::size_t N>
+void shm_ring_detach(ShmRing<T, N>* r) {
+    munmap(r, sizeof(ShmRing<T, N>));
+}
+
+// Destruye la cola (sin procesos operando), desmapea y cierra el memfd
+template <class T, std::size_t N>
+void shm_ring_destroy(ShmRing<T, N>* r, int fd) {
+    pthread_mutex_destroy(&r->mutex);
+    pthread_cond_destroy(&r->not_full);
+    pthread_cond_destroy(&r->not_empty);
+    shm_ring_detach(r);
+    close(fd);
+}
+
+/**
+ * Insertar elemento (cualquier productor, de cualquier proceso)
+ * Bloquea mientras la cola está llena
+ */
+template <class T, std::size_t N>
+void ring_push(ShmRing<T, N>* r, T value) {
+    shm_ring_lock(r);
+    while (r->count == N && !r->stop) {
+        r->wait_full++;
+        shm_ring_wait(r, &r->not_full);
+    }
+    if (!r->stop) {
+        r->buf[r->head] = value;
+        r->head = (r->head + 1) & ShmRing<T, N>::MASK;
+        r->count++;
+        r->total_produced++;
+        pthread_cond_signal(&r->not_empty);
+    }
+    pthread_mutex_unlock(&r->mutex);
+}
+
+/**
+ * Extraer elemento (cualquier consumidor, de cualquier proceso)
+ * Retorna false si la cola está vacía y se activó stop
+ */
+template <class T, std::size_t N>
+bool ring_pop(ShmRing<T, N>* r, T* output) {
+    shm_ring_lock(r);
+    while (r->count == 0 && !r->stop) {
+        r->wait_empty++;
+        shm_ring_wait(r, &r->not_empty);
+    }
+    if (r->count == 0) {
+        pthread_mutex_unlock(&r->mutex);
+        return false;
+    }
+    *output = r->buf[r->tail];
+    r->tail = (r->tail + 1) & ShmRing<T, N>::MASK;
+    r->count--;
+    r->total_consumed++;
+    pthread_cond_signal(&r->not_full);
+    pthread_mutex_unlock(&r->mutex);
+    return true;
+}
+
+template <class T, std::size_t N>
+void ring_shutdown(ShmRing<T, N>* r) {
+    shm_ring_lock(r);
+    r->stop = true;
+    pthread_cond_broadcast(&r->not_full);
+    pthread_cond_broadcast(&r->not_empty);
+    pthread_mutex_unlock(&r->mutex);
+}
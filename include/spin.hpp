@@ -0,0 +1,15 @@
+#pragma once
+
+/**
+ * Pausa de CPU para bucles de espera activa (PAUSE en x86, YIELD en ARM).
+ * Reduce el consumo y la penalización al salir del bucle.
+ */
+inline void cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield" ::: "memory");
+#else
+    asm volatile("" ::: "memory");
+#endif
+}
@@ -0,0 +1,183 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+#include "cacheline.hpp"
+#include "eventcount.hpp"
+#include "spin.hpp"
+
+/**
+ * Cola circular lock-free de un productor y un consumidor (SPSC).
+ * T debe ser copiable trivialmente (int, estructuras POD pequeñas).
+ * head lo escribe solo el productor y tail solo el consumidor; cada índice
+ * vive en su propia línea de caché junto con la copia local que su dueño
+ * guarda del índice contrario (cached_tail / cached_head). Así el productor
+ * solo lee tail cuando su copia indica cola llena, y el consumidor solo lee
+ * head cuando la suya indica cola vacía.
+ * Los índices crecen sin límite y se enmascaran con Capacity - 1.
+ * Misma semántica que Ring: push bloquea con cola llena, pop retorna false
+ * con cola vacía tras ring_shutdown().
+ * Espera: gira SPIN vueltas y luego duerme en un EventCount (futex); el
+ * otro extremo solo hace syscall si hay alguien dormido.
+ */
+template <std::size_t Capacity, class T = int>
+struct SpscRing {
+    using value_type = T;
+    static_assert(std::is_trivially_copyable<T>::value, "T debe ser copiable trivialmente");
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0,
+                  "Capacity debe ser potencia de dos");
+    static constexpr std::size_t MASK = Capacity - 1;
+    static constexpr int SPIN = 256;
+
+    // Línea del productor
+    alignas(CACHE_LINE) std::atomic<std::size_t> head{0};
+    std::size_t cached_tail = 0;
+    long total_produced = 0;
+    long wait_full = 0;
+
+    // Línea del consumidor
+    alignas(CACHE_LINE) std::atomic<std::size_t> tail{0};
+    std::size_t cached_head = 0;
+    long total_consumed = 0;
+    long wait_empty = 0;
+
+    alignas(CACHE_LINE) std::atomic<bool> stop{false};
+    alignas(CACHE_LINE) EventCount not_full;
+    alignas(CACHE_LINE) EventCount not_empty;
+
+    alignas(CACHE_LINE) T buf[Capacity];
+
+    // Elementos actuales (exacto solo en reposo)
+    std::size_t count() const {
+        return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire);
+    }
+};
+
+/**
+ * Insertar elemento (solo el hilo productor)
+ * Espera con retroceso mientras la cola está llena
+ */
+template <std::size_t N, class T>
+void ring_push(SpscRing<N, T>* r, T value) {
+    std::size_t h = r->head.load(std::memory_order_relaxed);
+    
+    if (h - r->cached_tail == N) {
+        r->cached_tail = r->tail.load(std::memory_order_acquire);
+        if (h - r->cached_tail == N) {
+            r->wait_full++;
+            r->not_full.await([r, h] {
+                r->cached_tail = r->tail.load(std::memory_order_acquire);
+                return h - r->cached_tail != N || r->stop.load(std::memory_order_acquire);
+            }, SpscRing<N, T>::SPIN);
+            if (h - r->cached_tail == N) return;  // stop
+        }
+    }
+    
+    r->buf[h & SpscRing<N, T>::MASK] = value;
+    r->head.store(h + 1, std::memory_order_release);  // Publica el elemento
+    r->total_produced++;
+    r->not_empty.notify();
+}
+
+/**
+ * Extraer elemento (solo el hilo consumidor)
+ * Retorna false si la cola está vacía y se activó stop
+ */
+template <std::size_t N, class T>
+bool ring_pop(SpscRing<N, T>* r, T* output) {
+    std::size_t t = r->tail.load(std::memory_order_relaxed);
+    
+    if (t == r->cached_head) {
+        r->cached_head = r->head.load(std::memory_order_acquire);
+        if (t == r->cached_head) {
+            r->wait_empty++;
+            r->not_empty.await([r, t] {
+                bool stopped = r->stop.load(std::memory_order_acquire);
+                // Releer head después de stop: el productor pudo publicar antes
+                r->cached_head = r->head.load(std::memory_order_acquire);
+                return t != r->cached_head || stopped;
+            }, SpscRing<N, T>::SPIN);
+            if (t == r->cached_head) return false;  // Vacía y stop
+        }
+    }
+    
+    *output = r->buf[t & SpscRing<N, T>::MASK];
+    r->tail.store(t + 1, std::memory_order_release);  // Libera la ranura
+    r->total_consumed++;
+    r->not_full.notify();
+    return true;
+}
+
+/**
+ * Insertar n elementos (solo el productor)
+ * Copia todo lo que quepa y lo publica con un único store de head
+ */
+template <std::size_t N, class T>
+void ring_push_n(SpscRing<N, T>* r, const T* values, std::size_t n) {
+    std::size_t done = 0;
+    
+    while (done < n) {
+        std::size_t h = r->head.load(std::memory_order_relaxed);
+        std::size_t free_slots = N - (h - r->cached_tail);
+        
+        if (free_slots == 0) {
+            r->cached_tail = r->tail.load(std::memory_order_acquire);
+            free_slots = N - (h - r->cached_tail);
+            if (free_slots == 0) {
+                r->wait_full++;
+                r->not_full.await([r, h] {
+                    r->cached_tail = r->tail.load(std::memory_order_acquire);
+                    return h - r->cached_tail != N || r->stop.load(std::memory_order_acquire);
+                }, SpscRing<N, T>::SPIN);
+                free_slots = N - (h - r->cached_tail);
+                if (free_slots == 0) return;  // stop
+            }
+        }
+        
+        std::size_t k = (n - done < free_slots) ? n - done : free_slots;
+        for (std::size_t j = 0; j < k; j++) {
+            r->buf[(h + j) & SpscRing<N, T>::MASK] = values[done + j];
+        }
+        r->head.store(h + k, std::memory_order_release);
+        r->total_produced += k;
+        done += k;
+        r->not_empty.notify();  // Una notificación por tramo
+    }
+}
+
+/**
+ * Extraer hasta max elementos (solo el consumidor)
+ * Retorna cuántos extrajo; 0 si la cola está vacía y se activó stop
+ */
+template <std::size_t N, class T>
+std::size_t ring_pop_n(SpscRing<N, T>* r, T* output, std::size_t max) {
+    if (max == 0 || !ring_pop(r, &output[0])) return 0;
+    
+    // Ya hay al menos uno; tomar el resto disponible sin esperar
+    std::size_t t = r->tail.load(std::memory_order_relaxed);
+    std::size_t avail = r->cached_head - t;
+    if (avail < max - 1) {
+        r->cached_head = r->head.load(std::memory_order_acquire);
+        avail = r->cached_head - t;
+    }
+    std::size_t k = (avail < max - 1) ? avail : max - 1;
+    for (std::size_t j = 0; j < k; j++) {
+        output[1 + j] = r->buf[(t + j) & SpscRing<N, T>::MASK];
+    }
+    if (k > 0) {
+        r->tail.store(t + k, std::memory_order_release);
+        r->total_consumed += k;
+        r->not_full.notify();
+    }
+    return 1 + k;
+}
+
+template <std::size_t N, class T>
+void ring_shutdown(SpscRing<N, T>* r) {
+    r->stop.store(true, std::memory_order_release);
+    r->not_full.notify();
+    r->not_empty.notify();
+}
+
+template <std::size_t N, class T>
+void ring_destroy(SpscRing<N, T>*) {}
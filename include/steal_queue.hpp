@@ -0,0 +1,150 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "cacheline.hpp"
+#include "eventcount.hpp"
+#include "mpmc_queue.hpp"
+
+/**
+ * Cola repartida en varias colas acotadas con robo de trabajo.
+ * Cada productor inserta siempre en su cola "casa" (id % shards), así que
+ * productores de colas distintas no comparten ninguna línea de caché.
+ * Cada consumidor extrae primero de su propia cola y, si está vacía, roba
+ * de víctimas recorridas desde una posición aleatoria.
+ *
+ * Orden: cada cola es FIFO y un productor usa siempre la misma, por lo que
+ * los elementos de un productor salen en el orden en que se insertaron
+ * (cada consumidor los ve en orden creciente). No hay orden global entre
+ * productores distintos.
+ *
+ * Cada hilo debe registrarse antes de operar con ring_attach_producer() /
+ * ring_attach_consumer(); la cola casa se guarda en una variable thread_local.
+ * La espera es como en MpmcQueue pero con un EventCount compartido por
+ * todas las colas: un consumidor dormido despierta con cualquier push.
+ */
+template <std::size_t Capacity, class T = int>
+struct StealQueue {
+    using value_type = T;
+    using Shard = MpmcQueue<Capacity, T>;
+    static constexpr int SPIN = 256;
+
+    // Cola casa y estado del generador de víctimas de cada hilo
+    struct Home {
+        std::size_t shard = 0;
+        uint32_t rng = 1;
+    };
+    static inline thread_local Home home;
+
+    std::vector<std::unique_ptr<Shard>> shards;
+
+    alignas(CACHE_LINE) std::atomic<bool> stop{false};
+    alignas(CACHE_LINE) EventCount not_full;
+    alignas(CACHE_LINE) EventCount not_empty;
+
+    // Estadísticas
+    alignas(CACHE_LINE) std::atomic<long> steals{0};   // Extracciones de una cola ajena
+    std::atomic<long> wait_full{0};
+    std::atomic<long> wait_empty{0};
+
+    explicit StealQueue(std::size_t count) {
+        if (count == 0) count = 1;
+        for (std::size_t i = 0; i < count; i++) {
+            shards.emplace_back(new Shard());
+        }
+    }
+
+    std::size_t size() const { return shards.size(); }
+
+    // Extrae de la cola casa o, si está vacía, de la primera víctima con datos
+    bool try_pop(T* output) {
+        std::size_t n = shards.size();
+        if (shards[home.shard]->try_pop(output)) return true;
+
+        // xorshift32: víctima inicial distinta por intento, sin estado compartido
+        uint32_t x = home.rng;
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        home.rng = x;
+
+        std::size_t start = x % n;
+        for (std::size_t k = 0; k < n; k++) {
+            std::size_t victim = (start + k) % n;
+            if (victim == home.shard) continue;
+            if (shards[victim]->try_pop(output)) {
+                steals.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool all_empty() const {
+        for (const auto& s : shards) {
+            if (!s->empty()) return false;
+        }
+        return true;
+    }
+};
+
+template <std::size_t N, class T>
+void ring_attach_producer(StealQueue<N, T>* q, int id) {
+    StealQueue<N, T>::home.shard = static_cast<std::size_t>(id) % q->size();
+}
+
+template <std::size_t N, class T>
+void ring_attach_consumer(StealQueue<N, T>* q, int id) {
+    StealQueue<N, T>::home.shard = static_cast<std::size_t>(id) % q->size();
+    StealQueue<N, T>::home.rng = 2654435761u * static_cast<uint32_t>(id + 1);
+}
+
+/**
+ * Insertar en la cola casa del productor
+ * Gira y luego duerme mientras esa cola está llena
+ */
+template <std::size_t N, class T>
+void ring_push(StealQueue<N, T>* q, T value) {
+    auto* shard = q->shards[StealQueue<N, T>::home.shard].get();
+    while (!shard->try_push(value)) {
+        q->wait_full.fetch_add(1, std::memory_order_relaxed);
+        q->not_full.await([q, shard] {
+            return !shard->full() || q->stop.load(std::memory_order_acquire);
+        }, StealQueue<N, T>::SPIN);
+        if (q->stop.load(std::memory_order_acquire)) return;
+    }
+    q->not_empty.notify();
+}
+
+/**
+ * Extraer de la cola casa o robar de otra
+ * Retorna false cuando todas las colas están vacías y se activó stop
+ */
+template <std::size_t N, class T>
+bool ring_pop(StealQueue<N, T>* q, T* output) {
+    while (!q->try_pop(output)) {
+        q->wait_empty.fetch_add(1, std::memory_order_relaxed);
+        q->not_empty.await([q] {
+            return !q->all_empty() || q->stop.load(std::memory_order_acquire);
+        }, StealQueue<N, T>::SPIN);
+        if (q->stop.load(std::memory_order_acquire)) {
+            // Cerrada: drenar lo que quede antes de salir
+            if (q->try_pop(output)) break;
+            return false;
+        }
+    }
+    q->not_full.notify();
+    return true;
+}
+
+template <std::size_t N, class T>
+void ring_shutdown(StealQueue<N, T>* q) {
+    q->stop.store(true, std::memory_order_release);
+    q->not_full.notify();
+    q->not_empty.notify();
+}
+
+template <std::size_t N, class T>
+void ring_destroy(StealQueue<N, T>*) {}
@@ -1,4 +1,5 @@
 #pragma once
+#include <cstdint>
 #include <ctime>
 
 /**
@@ -9,4 +10,14 @@ inline double now_s() {
     timespec ts{};
     clock_gettime(CLOCK_MONOTONIC, &ts);
     return ts.tv_sec + ts.tv_nsec * 1e-9;
-}
\ No newline at end of file
+}
+
+/**
+ * Tiempo actual en nanosegundos (CLOCK_MONOTONIC) como entero
+ * Útil para marcas de tiempo por elemento y histogramas de latencia
+ */
+inline uint64_t now_ns() {
+    timespec ts{};
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + ts.tv_nsec;
+}
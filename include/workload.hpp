@@ -0,0 +1,220 @@
+#pragma once
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Generador de cargas para tablas clave/valor (estilo YCSB).
+ * Antes de medir, cada hilo genera su secuencia completa de operaciones
+ * (tipo + clave) con un PRNG propio; el bucle medido solo la recorre, así
+ * el costo de sortear claves no se suma al de la tabla.
+ *
+ * Distribuciones de claves sobre [0, n):
+ *   uniforme   - todas las claves con la misma probabilidad
+ *   zipf       - el rango r con probabilidad ~ 1/(r+1)^θ (método de Gray
+ *                et al.); como en YCSB el rango se dispersa con FNV para
+ *                que las claves calientes no sean justo las cargadas primero
+ *   reciente   - zipf sobre la antigüedad: las claves insertadas hace poco
+ *                son las más leídas (YCSB-D)
+ *   hotspot    - una fracción `hot_fraction` de las claves recibe
+ *                `hot_ops` de los accesos, el resto se reparte uniforme
+ *
+ * Mezclas YCSB: A 50/50 lectura/actualización, B 95/5, C solo lectura,
+ * D 95% lectura / 5% inserción de claves nuevas.
+ */
+
+/**
+ * xoshiro256** (Blackman y Vigna): 4 palabras de estado por hilo, sin
+ * divisiones ni estado compartido. Se siembra con splitmix64.
+ */
+struct FastRng {
+    uint64_t s[4];
+
+    explicit FastRng(uint64_t seed) {
+        for (auto& word : s) {
+            seed += 0x9e3779b97f4a7c15ULL;   // splitmix64
+            uint64_t z = seed;
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+            word = z ^ (z >> 31);
+        }
+    }
+
+    static uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+    uint64_t next() {
+        uint64_t result = rotl(s[1] * 5, 7) * 9;
+        uint64_t t = s[1] << 17;
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = rotl(s[3], 45);
+        return result;
+    }
+
+    // Entero en [0, n) por multiplicación (Lemire), sin módulo
+    uint32_t below(uint32_t n) {
+        return static_cast<uint32_t>(((next() >> 32) * n) >> 32);
+    }
+
+    // Real en [0, 1) con 53 bits
+    double uniform() { return (next() >> 11) * (1.0 / 9007199254740992.0); }
+};
+
+enum KeyDist {
+    DIST_UNIFORM = 0,
+    DIST_ZIPFIAN,
+    DIST_LATEST,
+    DIST_HOTSPOT,
+    DIST_COUNT
+};
+
+inline const char* key_dist_name(KeyDist d) {
+    static const char* names[DIST_COUNT] = {"uniforme", "zipf", "reciente", "hotspot"};
+    return names[d];
+}
+
+// Constantes de zipf para n claves y exponente θ en (0, 1); zeta(n) es O(n)
+struct ZipfParams {
+    uint32_t n = 0;
+    double theta = 0;
+    double alpha = 0;
+    double zetan = 0;
+    double eta = 0;
+    double half_pow_theta = 0;
+
+    ZipfParams() = default;
+
+    ZipfParams(uint32_t items, double th) : n(items), theta(th) {
+        double zeta2 = 0;
+        for (uint32_t i = 1; i <= n; i++) {
+            zetan += 1.0 / std::pow(static_cast<double>(i), theta);
+            if (i == 2) zeta2 = zetan;
+        }
+        alpha = 1.0 / (1.0 - theta);
+        eta = (1.0 - std::pow(2.0 / n, 1.0 - theta)) / (1.0 - zeta2 / zetan);
+        half_pow_theta = 1.0 + std::pow(0.5, theta);
+    }
+
+    // Rango en [0, n): 0 es el más frecuente
+    uint32_t next(FastRng& rng) const {
+        double u = rng.uniform();
+        double uz = u * zetan;
+        if (uz < 1.0) return 0;
+        if (uz < half_pow_theta) return 1;
+        auto r = static_cast<uint32_t>(n * std::pow(eta * u - eta + 1.0, alpha));
+        return r < n ? r : n - 1;
+    }
+};
+
+// FNV-1a de 64 bits sobre los 8 bytes del valor (dispersión de rangos zipf)
+inline uint64_t fnv1a64(uint64_t v) {
+    uint64_t h = 0xcbf29ce484222325ULL;
+    for (int i = 0; i < 8; i++) {
+        h ^= v & 0xff;
+        h *= 0x100000001b3ULL;
+        v >>= 8;
+    }
+    return h;
+}
+
+enum OpType : uint8_t {
+    OP_READ = 0,
+    OP_UPDATE,     // put sobre una clave del espacio sorteado
+    OP_INSERT,     // put de una clave nueva (más allá del espacio inicial)
+    OP_REMOVE
+};
+
+// Porcentajes de cada tipo de operación (suman 100)
+struct OpMix {
+    const char* name;
+    int read;
+    int update;
+    int insert;
+    int remove;
+};
+
+constexpr OpMix YCSB_A = {"YCSB-A", 50, 50, 0, 0};
+constexpr OpMix YCSB_B = {"YCSB-B", 95, 5, 0, 0};
+constexpr OpMix YCSB_C = {"YCSB-C", 100, 0, 0, 0};
+constexpr OpMix YCSB_D = {"YCSB-D", 95, 0, 5, 0};
+
+inline const OpMix* ycsb_mix(char letter) {
+    switch (letter) {
+        case 'a': case 'A': return &YCSB_A;
+        case 'b': case 'B': return &YCSB_B;
+        case 'c': case 'C': return &YCSB_C;
+        case 'd': case 'D': return &YCSB_D;
+        default: return nullptr;
+    }
+}
+
+struct WorkOp {
+    OpType type;
+    int key;
+};
+
+struct WorkloadSpec {
+    OpMix mix;
+    KeyDist dist = DIST_UNIFORM;
+    uint32_t key_range = 10000;
+    const ZipfParams* zipf = nullptr;   // Requerido por zipf y reciente (n = key_range)
+    double hot_fraction = 0.2;
+    double hot_ops = 0.8;
+};
+
+/**
+ * Secuencia de `ops` operaciones del hilo `thread_id` de `threads`.
+ * Las inserciones usan claves key_range + k*threads + thread_id, sin
+ * repetirse entre hilos. Para "reciente" la clave más nueva se estima
+ * suponiendo que todos los hilos insertan al mismo ritmo.
+ */
+inline std::vector<WorkOp> make_op_stream(const WorkloadSpec& w, int thread_id, int threads, long ops) {
+    FastRng rng(0x5eed0000ULL + static_cast<uint64_t>(thread_id) * 7919);
+    std::vector<WorkOp> stream(static_cast<std::size_t>(ops));
+    uint32_t hot_n = static_cast<uint32_t>(w.key_range * w.hot_fraction);
+    if (hot_n == 0) hot_n = 1;
+    long inserted = 0;
+
+    for (auto& op : stream) {
+        uint32_t r = rng.below(100);
+        if (r < static_cast<uint32_t>(w.mix.read)) {
+            op.type = OP_READ;
+        } else if (r < static_cast<uint32_t>(w.mix.read + w.mix.update)) {
+            op.type = OP_UPDATE;
+        } else if (r < static_cast<uint32_t>(w.mix.read + w.mix.update + w.mix.insert)) {
+            op.type = OP_INSERT;
+        } else {
+            op.type = OP_REMOVE;
+        }
+
+        if (op.type == OP_INSERT) {
+            op.key = static_cast<int>(w.key_range + inserted * threads + thread_id);
+            inserted++;
+            continue;
+        }
+
+        switch (w.dist) {
+            case DIST_ZIPFIAN:
+                op.key = static_cast<int>(fnv1a64(w.zipf->next(rng)) % w.key_range);
+                break;
+            case DIST_LATEST: {
+                long latest = static_cast<long>(w.key_range) - 1 + inserted * threads;
+                long key = latest - w.zipf->next(rng);
+                op.key = static_cast<int>(key < 0 ? 0 : key);
+                break;
+            }
+            case DIST_HOTSPOT:
+                op.key = static_cast<int>(rng.uniform() < w.hot_ops || hot_n >= w.key_range
+                                          ? rng.below(hot_n)
+                                          : hot_n + rng.below(w.key_range - hot_n));
+                break;
+            default:
+                op.key = static_cast<int>(rng.below(w.key_range));
+                break;
+        }
+    }
+    return stream;
+}
@@ -53,6 +53,22 @@ def extract_operations(content):
     
     return operations
 
+LATENCY_PERCENTILES = ['p50', 'p90', 'p99', 'p99.9']
+
+def extract_latency(content):
+    """Extrae percentiles de latencia por item ("Latencia p99: 12.34 us")"""
+    latency = {}
+    for name in LATENCY_PERCENTILES + ['max']:
+        matches = re.findall(r'Latencia ' + re.escape(name) + r':\s+(\d+(?:\.\d+)?)\s+us', content)
+        if matches:
+            latency[name] = [float(m) for m in matches]
+    return latency
+
+def extract_target_rate(content):
+    """Extrae la tasa objetivo del lazo abierto (p2_ring -r)"""
+    matches = re.findall(r'Tasa objetivo:\s+(\d+(?:\.\d+)?)\s+elementos/segundo', content)
+    return [float(m) for m in matches]
+
 def analyze_file(filepath):
     """Analiza un archivo de resultados individual"""
     try:
@@ -70,6 +86,8 @@ def analyze_file(filepath):
             'throughput': [],
             'time': [],
             'operations': [],
+            'latency': defaultdict(list),
+            'target_rate': [],
             'errors': 0,
             'timeouts': 0
         }
@@ -90,6 +108,9 @@ def analyze_file(filepath):
             results['throughput'].extend(throughput)
             results['time'].extend(time)
             results['operations'].extend(operations)
+            results['target_rate'].extend(extract_target_rate(run_content))
+            for name, values in extract_latency(run_content).items():
+                results['latency'][name].extend(values)
         
         return results
         
@@ -168,6 +189,13 @@ def generate_report(results_dir):
             print(f"🔢 Operaciones completadas:")
             print(f"   Promedio: {stats['mean']:.0f}")
             print(f"   Rango: {stats['min']:.0f} - {stats['max']:.0f}")
+        
+        # Latencia por item (p2_ring -l)
+        if results['latency']:
+            print(f"⏳ Latencia encolado->desencolado (us, mediana de runs):")
+            for name in LATENCY_PERCENTILES + ['max']:
+                if name in results['latency']:
+                    print(f"   {name}: {statistics.median(results['latency'][name]):.2f}")
     
     # Generar comparativas por práctica
     print("\n" + "="*60)
@@ -200,7 +228,7 @@ def generate_report(results_dir):
     csv_data = []
     for filename, results in all_results.items():
         if results['throughput'] and results['time']:
-            csv_data.append({
+            row = {
                 'archivo': filename,
                 'practica': filename.split('_')[0],
                 'throughput_promedio': statistics.mean(results['throughput']),
@@ -209,7 +237,12 @@ def generate_report(results_dir):
                 'tiempo_std': statistics.stdev(results['time']) if len(results['time']) > 1 else 0,
                 'errores': results['errors'],
                 'timeouts': results['timeouts']
-            })
+            }
+            for name in LATENCY_PERCENTILES + ['max']:
+                values = results['latency'].get(name)
+                row[f'latencia_{name}_us'] = statistics.median(values) if values else None
+            row['tasa_objetivo'] = results['target_rate'][0] if results['target_rate'] else None
+            csv_data.append(row)
     
     if csv_data:
         df = pd.DataFrame(csv_data)
@@ -266,6 +299,72 @@ def plot_results(results_dir):
     except Exception as e:
         print(f"❌ Error generando gráficos: {e}")
 
+def plot_latency(results_dir):
+    """Grafica percentiles de latencia por configuración (escala logarítmica)"""
+    csv_path = os.path.join(results_dir, 'analysis_summary.csv')
+    if not os.path.exists(csv_path):
+        return
+    
+    df = pd.read_csv(csv_path)
+    columns = [f'latencia_{name}_us' for name in LATENCY_PERCENTILES]
+    columns = [c for c in columns if c in df.columns]
+    if not columns:
+        return
+    df = df.dropna(subset=columns, how='all')
+    if df.empty:
+        return
+    
+    plt.figure(figsize=(12, 8))
+    labels = [name for name in LATENCY_PERCENTILES if f'latencia_{name}_us' in columns]
+    for _, row in df.iterrows():
+        plt.plot(labels, [row[c] for c in columns], marker='o',
+                 label=row['archivo'].replace('.txt', ''))
+    
+    plt.title('Latencia encolado->desencolado por percentil')
+    plt.xlabel('Percentil')
+    plt.ylabel('Latencia (us)')
+    plt.yscale('log')
+    plt.legend(fontsize='small')
+    plt.tight_layout()
+    
+    plot_path = os.path.join(results_dir, 'latency_percentiles.png')
+    plt.savefig(plot_path)
+    print(f"📈 Gráfico guardado en: {plot_path}")
+    plt.close()
+
+def plot_rate_sweep(results_dir):
+    """Latencia p99 vs tasa objetivo por cola (archivos p2_ring_rate_<modo>_<tasa>.txt)"""
+    csv_path = os.path.join(results_dir, 'analysis_summary.csv')
+    if not os.path.exists(csv_path):
+        return
+    
+    df = pd.read_csv(csv_path)
+    if 'tasa_objetivo' not in df.columns:
+        return
+    df = df.dropna(subset=['tasa_objetivo', 'latencia_p99_us'])
+    df = df[df['archivo'].str.startswith('p2_ring_rate_')]
+    if df.empty:
+        return
+    df = df.assign(modo=df['archivo'].str.extract(r'p2_ring_rate_([a-z]+)_')[0])
+    
+    plt.figure(figsize=(12, 8))
+    for mode, group in df.groupby('modo'):
+        group = group.sort_values('tasa_objetivo')
+        plt.plot(group['tasa_objetivo'], group['latencia_p99_us'], marker='o', label=mode)
+    
+    plt.title('Lazo abierto: latencia p99 vs tasa objetivo')
+    plt.xlabel('Tasa objetivo (elementos/s)')
+    plt.ylabel('Latencia p99 (us)')
+    plt.xscale('log')
+    plt.yscale('log')
+    plt.legend()
+    plt.tight_layout()
+    
+    plot_path = os.path.join(results_dir, 'rate_sweep_p99.png')
+    plt.savefig(plot_path)
+    print(f"📈 Gráfico guardado en: {plot_path}")
+    plt.close()
+
 if __name__ == "__main__":
     results_dir = "results"
     
@@ -278,4 +377,10 @@ if __name__ == "__main__":
     try:
         plot_results(results_dir)
     except:
-        pass  # Silently fail if plotting libraries not available
\ No newline at end of file
+        pass  # Silently fail if plotting libraries not available
+    
+    try:
+        plot_latency(results_dir)
+        plot_rate_sweep(results_dir)
+    except Exception as e:
+        print(f"❌ Error generando gráfico de latencia: {e}")
\ No newline at end of file
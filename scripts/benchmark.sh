@@ -69,7 +69,7 @@ fi
 echo "BENCHMARK 1: Counter Race Conditions"
 echo "====================================="
 
-# Diferentes números de hilos
+# Diferentes números de hilos (incluye variante E: ShardedCounter con padding)
 for threads in 1 2 4 8; do
     iterations=1000000
     run_benchmark "./bin/p1_counter" "$threads $iterations 1" \
@@ -85,11 +85,29 @@ for load in 500000 1000000 2000000; do
         "P1 Counter: $threads hilos, $load iteraciones"
 done
 
+# Sobresuscripción: por hilo (C, E) vs atomic (D) vs por CPU (F), T = 1..4×nproc
+NPROC=$(nproc)
+for mult in 1 2 3 4; do
+    threads=$((NPROC * mult))
+    iterations=1000000
+    run_benchmark "./bin/p1_counter" "$threads $iterations 1 CDEF" \
+        "p1_counter_percpu_t${threads}.txt" \
+        "P1 Counter por CPU: $threads hilos (${mult}x nproc), $iterations iteraciones"
+done
+
+# Combinación: mutex (B) y atomic (D) vs flat combining (H) y árbol (I)
+for threads in 2 4 8 16 32; do
+    iterations=200000
+    run_benchmark "./bin/p1_counter" "$threads $iterations 1 BDHI" \
+        "p1_counter_combining_t${threads}.txt" \
+        "P1 Counter combinación: $threads hilos, $iterations iteraciones"
+done
+
 # BENCHMARK 2: Buffer Circular
 echo "BENCHMARK 2: Buffer Circular"
 echo "============================"
 
-# Configuraciones balanceadas
+# Configuraciones balanceadas (4º campo opcional: modo de cola)
 configs=(
     "1 1 100000"
     "2 2 100000" 
@@ -98,16 +116,73 @@ configs=(
     "1 2 100000"
     "4 2 50000"
     "2 4 50000"
+    "1 1 100000 spsc"
+    "2 2 100000 mpmc"
+    "4 4 50000 mpmc"
+    "4 2 50000 mpmc"
+    "2 4 50000 mpmc"
+    "1 1 100000 payload"
+    "1 1 100000 futex"
+    "2 2 100000 futex"
+    "4 4 50000 futex"
+    "4 4 50000 steal"
+    "8 8 25000 mpmc"
+    "8 8 25000 steal"
+    "16 16 12500 mpmc"
+    "16 16 12500 steal"
+    "16 4 12500 steal"
+    "2 2 100000 unbounded"
+    "4 4 50000 unbounded"
+    "2 2 100000 burst"
+    "4 2 50000 burst"
+    "1 1 200000 ipc"
+    "4 1 50000 ipc"
+    "1 1 1000000 bytes"
+    "8 1 50000 select"
+    "16 1 25000 select"
 )
 
 for config in "${configs[@]}"; do
     producers=$(echo $config | cut -d' ' -f1)
     consumers=$(echo $config | cut -d' ' -f2)
     items=$(echo $config | cut -d' ' -f3)
+    mode=$(echo $config | cut -d' ' -f4)
+    suffix=""
+    if [ -n "$mode" ]; then
+        suffix="_${mode}"
+    fi
     
     run_benchmark "./bin/p2_ring" "$config" \
-        "p2_ring_p${producers}c${consumers}i${items}.txt" \
-        "P2 Ring: ${producers}P/${consumers}C, $items items/producer"
+        "p2_ring_p${producers}c${consumers}i${items}${suffix}.txt" \
+        "P2 Ring: ${producers}P/${consumers}C, $items items/producer ${mode}"
+done
+
+# Tamaño de lote: throughput vs latencia por item (histograma con -l)
+for batch in 1 4 16 64 256; do
+    run_benchmark "./bin/p2_ring" "2 2 100000 mutex -b $batch -l" \
+        "p2_ring_p2c2i100000_b${batch}.txt" \
+        "P2 Ring por lotes: 2P/2C, lote $batch"
+done
+
+# Latencia por item de cada cola (sin lotes)
+for mode in mutex futex mpmc; do
+    run_benchmark "./bin/p2_ring" "2 2 100000 $mode -l" \
+        "p2_ring_p2c2i100000_${mode}_lat.txt" \
+        "P2 Ring latencia: 2P/2C, modo $mode"
+done
+run_benchmark "./bin/p2_ring" "1 1 100000 spsc -l" \
+    "p2_ring_p1c1i100000_spsc_lat.txt" \
+    "P2 Ring latencia: 1P/1C, modo spsc"
+
+# Lazo abierto: barrido de tasa por cola (latencia desde el envío programado)
+# Cada corrida dura ~0.5 s: items por productor = tasa / 4 con 2 productores
+for mode in mutex futex mpmc steal unbounded; do
+    for rate in 50000 100000 200000 400000 800000 1600000; do
+        items=$((rate / 4))
+        run_benchmark "./bin/p2_ring" "2 2 $items $mode -r $rate" \
+            "p2_ring_rate_${mode}_${rate}.txt" \
+            "P2 Ring lazo abierto: 2P/2C, modo $mode, $rate elementos/s"
+    done
 done
 
 # BENCHMARK 3: Lectores/Escritores
@@ -122,6 +197,27 @@ for threads in 2 4 6 8; do
         "P3 RW Lock: $threads hilos, $operations ops/hilo"
 done
 
+# Número de franjas de la variante STRIPED (1 franja = un rwlock global)
+for stripes in 1 8 64 256; do
+    run_benchmark "./bin/p3_rw" "4 50000 -s $stripes" \
+        "p3_rw_s${stripes}.txt" \
+        "P3 RW Lock: 4 hilos, $stripes franjas"
+done
+
+# Proporción de borrados (ejercita la recuperación por épocas; sin -d no hay)
+for removes in 20 50; do
+    run_benchmark "./bin/p3_rw" "4 50000 -d $removes" \
+        "p3_rw_d${removes}.txt" \
+        "P3 RW Lock: 4 hilos, $removes% de escrituras son borrados"
+done
+
+# Mezclas YCSB por distribución de claves, con dos tamaños de espacio
+for keys in 10000 100000; do
+    run_benchmark "./bin/p3_rw" "4 100000 -w abcd -k $keys" \
+        "p3_rw_ycsb_k${keys}.txt" \
+        "P3 YCSB A/B/C/D: 4 hilos, $keys claves"
+done
+
 # BENCHMARK 4: Deadlock Solutions (solo soluciones seguras)
 echo "BENCHMARK 4: Deadlock Solutions"
 echo "==============================="
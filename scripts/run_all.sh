@@ -102,9 +102,9 @@ echo "- data/pipeline.log (si P5 ejecutó correctamente)"
 echo "- Binarios en bin/"
 echo ""
 echo "Para ejecutar prácticas individuales:"
-echo "  ./bin/p1_counter [hilos] [iteraciones] [repeticiones]"
-echo "  ./bin/p2_ring [productores] [consumidores] [items_por_productor]"
-echo "  ./bin/p3_rw [hilos] [operaciones_por_hilo]"
+echo "  ./bin/p1_counter [hilos] [iteraciones] [repeticiones] [variantes]"
+echo "  ./bin/p2_ring [productores] [consumidores] [items_por_productor] [modo] [-b lote] [-l] [-r tasa] [-q colas] [-i ms]"
+echo "  ./bin/p3_rw [hilos] [operaciones_por_hilo] [-s franjas] [-d borrados] [-k claves] [-w abcd] [-z theta]"
 echo "  ./bin/p4_deadlock [1=demo|2=orden|3=trylock|0=todo]"
 echo "  ./bin/p5_pipeline"
 echo ""
@@ -8,14 +8,22 @@
  * B) Protección con pthread_mutex_t
  * C) Contadores particionados (sharded) con reduce
  * D) Comparación con std::atomic<long>
+ * E) ShardedCounter con ranuras alineadas a línea de caché
+ * F) PerCpuCounter: ranura por CPU (sched_getcpu) con volcado por lotes
+ * G) SloppyCounter: contador aproximado con error acotado por T*S
+ * H) Flat combining: un hilo aplica en lote las peticiones de los demás
+ * I) Árbol de combinación por software
  */
 
 #include <pthread.h>
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include <vector>
 #include <atomic>
 #include "../include/timing.hpp"
+#include "../include/counters.hpp"
+#include "../include/perf_counters.hpp"
 
 struct Args {
     long iters;
@@ -65,6 +73,66 @@ void* worker_atomic(void* p) {
     return nullptr;
 }
 
+// E) Versión sharded con padding - una línea de caché por hilo
+ShardedCounter sharded_counter;
+
+void* worker_sharded_padded(void* p) {
+    auto* a = static_cast<Args*>(p);
+    for (long i = 0; i < a->iters; i++) {
+        sharded_counter.increment(a->thread_id);  // Sin false sharing
+    }
+    return nullptr;
+}
+
+// F) Versión por CPU - delta local, volcado cada K incrementos
+constexpr long PERCPU_BATCH = 64;
+PerCpuCounter percpu_counter;
+
+void* worker_percpu(void* p) {
+    auto* a = static_cast<Args*>(p);
+    PerCpuCounter::Local local;
+    for (long i = 0; i < a->iters; i++) {
+        percpu_counter.increment(local);
+    }
+    percpu_counter.flush(local);  // Volcar el resto antes de terminar
+    return nullptr;
+}
+
+// G) Versión sloppy - empuja al global cada S incrementos
+const long SLOPPY_THRESHOLDS[] = {16, 256, 4096};
+long sloppy_threshold = 256;
+SloppyCounter sloppy_counter;
+
+void* worker_sloppy(void* p) {
+    auto* a = static_cast<Args*>(p);
+    for (long i = 0; i < a->iters; i++) {
+        sloppy_counter.increment(a->thread_id);
+    }
+    return nullptr;
+}
+
+// H) Versión flat combining - un combinador aplica el lote bajo el lock
+FlatCombiningCounter fc_counter;
+
+void* worker_flat_combining(void* p) {
+    auto* a = static_cast<Args*>(p);
+    for (long i = 0; i < a->iters; i++) {
+        fc_counter.increment(a->thread_id);
+    }
+    return nullptr;
+}
+
+// I) Versión árbol de combinación - la raíz recibe sumas parciales
+CombiningTree tree_counter;
+
+void* worker_combining_tree(void* p) {
+    auto* a = static_cast<Args*>(p);
+    for (long i = 0; i < a->iters; i++) {
+        tree_counter.get_and_increment(a->thread_id);
+    }
+    return nullptr;
+}
+
 void run_test(const char* name, void* (*worker)(void*), int T, long iterations) {
     printf("\n=== %s ===\n", name);
     
@@ -76,12 +144,18 @@ void run_test(const char* name, void* (*worker)(void*), int T, long iterations)
     
     // Reset atomic counter
     atomic_counter.store(0);
+    sharded_counter.reset(T);
+    percpu_counter.reset(PERCPU_BATCH);
+    sloppy_counter.reset(T, sloppy_threshold);
+    fc_counter.reset(T);
+    tree_counter.reset(T);
     
     // Preparar argumentos para cada hilo
     for (int i = 0; i < T; i++) {
         args[i] = {iterations, &global, &mtx, local_counters.data(), i};
     }
     
+    PerfScope perf;  // Solo activo con LAB6_PERF=1
     double start = now_s();
     
     // Crear hilos
@@ -95,6 +169,7 @@ void run_test(const char* name, void* (*worker)(void*), int T, long iterations)
     }
     
     double end = now_s();
+    perf.stop();
     double elapsed = end - start;
     
     // Para versión sharded, hacer reduce
@@ -109,6 +184,29 @@ void run_test(const char* name, void* (*worker)(void*), int T, long iterations)
         global = atomic_counter.load();
     }
     
+    // Para versión sharded con padding, snapshot de todas las ranuras
+    if (worker == worker_sharded_padded) {
+        global = sharded_counter.read();
+    }
+    
+    // Para versión por CPU, agregar las ranuras (todos los hilos ya volcaron)
+    if (worker == worker_percpu) {
+        global = percpu_counter.read();
+    }
+    
+    // Para versión sloppy, el resultado es read_exact(); se reporta el error de read()
+    if (worker == worker_sloppy) {
+        global = sloppy_counter.read_exact();
+    }
+    
+    if (worker == worker_flat_combining) {
+        global = fc_counter.read();
+    }
+    
+    if (worker == worker_combining_tree) {
+        global = tree_counter.read();
+    }
+    
     long expected = (long)T * iterations;
     double ops_per_sec = (expected) / elapsed;
     
@@ -116,27 +214,68 @@ void run_test(const char* name, void* (*worker)(void*), int T, long iterations)
     printf("Resultado: %ld (esperado: %ld)\n", global, expected);
     printf("Diferencia: %ld (%.2f%%)\n", expected - global, 
            100.0 * (expected - global) / expected);
+    if (worker == worker_sloppy) {
+        long approx = sloppy_counter.read();
+        printf("Sloppy S=%ld: read()=%ld, error observado: %ld (cota T*S: %ld)\n",
+               sloppy_counter.threshold(), approx, expected - approx,
+               sloppy_counter.max_error());
+    }
+    if (worker == worker_flat_combining) {
+        printf("Peticiones combinadas por pasada: %.2f\n", fc_counter.avg_batch());
+    }
     printf("Tiempo: %.4f segundos\n", elapsed);
     printf("Throughput: %.0f ops/sec\n", ops_per_sec);
+    perf.print();
     
     pthread_mutex_destroy(&mtx);
 }
 
+struct Variant {
+    char id;
+    const char* name;
+    void* (*worker)(void*);
+};
+
+const Variant VARIANTS[] = {
+    {'A', "A) NAIVE (Race Condition)", worker_naive},
+    {'B', "B) MUTEX (Protegido)", worker_mutex},
+    {'C', "C) SHARDED (Sin contención)", worker_sharded},
+    {'D', "D) ATOMIC (C++17)", worker_atomic},
+    {'E', "E) SHARDED PADDED (Sin false sharing)", worker_sharded_padded},
+    {'F', "F) PER-CPU (sched_getcpu + lotes)", worker_percpu},
+    {'G', "G) SLOPPY (Error acotado)", worker_sloppy},
+    {'H', "H) FLAT COMBINING (Lote bajo lock)", worker_flat_combining},
+    {'I', "I) COMBINING TREE (Árbol de combinación)", worker_combining_tree},
+};
+
 int main(int argc, char** argv) {
     int T = (argc > 1) ? std::atoi(argv[1]) : 4;
     long iterations = (argc > 2) ? std::atol(argv[2]) : 1000000;
     int runs = (argc > 3) ? std::atoi(argv[3]) : 1;
+    // Variantes a ejecutar, p.ej. "CDF" (por defecto todas)
+    const char* selected = (argc > 4) ? argv[4] : nullptr;
     
     printf("Laboratorio 6 - Práctica 1: Race Conditions en Contador\n");
     printf("Configuración: %d hilos, %ld iteraciones por hilo\n", T, iterations);
+    printf("CPUs: %d, lote por CPU: %ld\n", PerCpuCounter::online_cpus(), PERCPU_BATCH);
     
     for (int run = 0; run < runs; run++) {
         printf("\n>>> EJECUCIÓN %d <<<\n", run + 1);
         
-        run_test("A) NAIVE (Race Condition)", worker_naive, T, iterations);
-        run_test("B) MUTEX (Protegido)", worker_mutex, T, iterations);
-        run_test("C) SHARDED (Sin contención)", worker_sharded, T, iterations);
-        run_test("D) ATOMIC (C++17)", worker_atomic, T, iterations);
+        for (const Variant& v : VARIANTS) {
+            if (selected && !std::strchr(selected, v.id)) continue;
+            if (v.worker == worker_sloppy) {
+                // Un test por umbral S para comparar throughput vs error
+                for (long S : SLOPPY_THRESHOLDS) {
+                    char name[64];
+                    snprintf(name, sizeof(name), "%s S=%ld", v.name, S);
+                    sloppy_threshold = S;
+                    run_test(name, v.worker, T, iterations);
+                }
+                continue;
+            }
+            run_test(v.name, v.worker, T, iterations);
+        }
     }
     
     printf("\n=== ANÁLISIS ===\n");
@@ -144,6 +283,11 @@ int main(int argc, char** argv) {
     printf("2. MUTEX: Correcto pero con alta contención\n");
     printf("3. SHARDED: Mayor throughput, requiere reduce\n");
     printf("4. ATOMIC: Balance entre corrección y rendimiento\n");
+    printf("5. SHARDED PADDED: Como SHARDED pero sin false sharing entre ranuras\n");
+    printf("6. PER-CPU: Memoria por CPU, no por hilo; escala con T > núcleos\n");
+    printf("7. SLOPPY: read() barato con error < T*S; read_exact() suma ranuras\n");
+    printf("8. FLAT COMBINING: Un lock por lote, no por incremento\n");
+    printf("9. COMBINING TREE: Reparte la contención; gana con muchos hilos\n");
     
     return 0;
 }
\ No newline at end of file
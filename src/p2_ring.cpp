@@ -6,20 +6,101 @@
  * Implementa una cola FIFO acotada con pthread_mutex_t y pthread_cond_t
  * Soporta múltiples productores y consumidores (MPMC)
  * Evita busy waiting usando condition variables
+ * Modo "spsc": cola lock-free de un productor/un consumidor para comparar
+ * Modo "mpmc": cola lock-free acotada con celdas numeradas (MPMC)
+ * Opción -b: operaciones por lotes (ring_push_n / ring_pop_n)
+ * Opción -l: items con marca de tiempo e histograma de latencia por item
+ * Opción -r tasa: productores en lazo abierto a tasa fija (latencia desde el envío programado)
+ * Modo "payload": Ring<T> con POD de 64 bytes y tipos dueños de memoria
+ * Modo "futex": Ring con espera giro + EventCount (futex), sin condvars
+ * Modo "steal": una cola por productor y consumidores que roban (-q colas)
+ * Modo "unbounded": cola no acotada de segmentos con pool (-i ms de inactividad)
+ * Modo "burst": productores en ráfagas, Ring acotado vs segmentos, con RSS
+ * Modo "ipc": productores en procesos (fork): ShmRing vs Ring vs pipe
+ * Modo "bytes": ByteRing con mensajes de 16 B a 64 KB (reserve/commit, peek/release)
+ * Modo "select": P colas; un consumidor con ring_select vs un hilo por cola
  */
 
 #include <pthread.h>
+#include <cerrno>
 #include <cstdio>
 #include <cstddef>
+#include <cstdint>
 #include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <new>
+#include <utility>
 #include <vector>
 #include <unistd.h>
+#include <getopt.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
 #include "../include/timing.hpp"
+#include "../include/cacheline.hpp"
+#include "../include/spsc_ring.hpp"
+#include "../include/mpmc_queue.hpp"
+#include "../include/steal_queue.hpp"
+#include "../include/segmented_queue.hpp"
+#include "../include/shm_ring.hpp"
+#include "../include/eventcount.hpp"
+#include "../include/histogram.hpp"
 
 constexpr std::size_t QUEUE_SIZE = 1024;
+constexpr std::size_t STEAL_SHARD_SIZE = QUEUE_SIZE;  // Capacidad de cada cola del modo steal
 
+/**
+ * Resultado de las operaciones sin bloqueo o con plazo sobre Ring
+ * RING_AGAIN: la cola estaba llena/vacía y se agotó el plazo (o no se esperó)
+ */
+enum RingStatus { RING_OK, RING_AGAIN, RING_CLOSED };
+
+constexpr uint64_t RING_NO_WAIT = 0;            // Plazo para try_push / try_pop
+constexpr uint64_t RING_FOREVER = UINT64_MAX;   // Sin plazo
+
+/**
+ * Aviso compartido por varias Ring para ring_select()
+ * Cada Ring asociada notifica este EventCount al insertar o cerrarse, así
+ * un consumidor duerme en un solo futex para todas sus colas
+ */
+struct RingSelector {
+    EventCount ready;
+    std::atomic<std::size_t> next{0};   // Cola por la que empieza el próximo recorrido
+};
+
+// Espera en una condvar hasta el plazo; false si venció
+inline bool ring_cond_wait(pthread_cond_t* cond, pthread_mutex_t* mutex, uint64_t deadline_ns) {
+    if (deadline_ns == RING_FOREVER) {
+        pthread_cond_wait(cond, mutex);
+        return true;
+    }
+    timespec ts;
+    ts.tv_sec = static_cast<time_t>(deadline_ns / 1000000000ULL);
+    ts.tv_nsec = static_cast<long>(deadline_ns % 1000000000ULL);
+    return pthread_cond_clockwait(cond, mutex, CLOCK_MONOTONIC, &ts) != ETIMEDOUT;
+}
+
+/**
+ * Cola circular acotada genérica protegida con mutex + condvars
+ * Capacity debe ser potencia de dos: el índice avanza con & MASK, sin módulo
+ * Las ranuras son memoria cruda: los elementos se construyen en el lugar
+ * (ring_emplace) y se mueven al extraerlos; T puede ser de solo movimiento
+ */
+template <class T, std::size_t Capacity = QUEUE_SIZE>
 struct Ring {
-    int buf[QUEUE_SIZE];
+    using value_type = T;
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0,
+                  "Capacity debe ser potencia de dos");
+    static constexpr std::size_t MASK = Capacity - 1;
+    
+    struct alignas(T) Slot {
+        unsigned char bytes[sizeof(T)];
+    };
+    
+    Slot buf[Capacity];        // Sin construir T por adelantado
     std::size_t head = 0;      // Índice de escritura
     std::size_t tail = 0;      // Índice de lectura
     std::size_t count = 0;     // Elementos actuales
@@ -29,63 +110,142 @@ struct Ring {
     pthread_cond_t not_empty = PTHREAD_COND_INITIALIZER;
     
     bool stop = false;         // Señal de parada
+    RingSelector* selector = nullptr;   // Aviso de ring_select (asociar antes de usar)
     
     // Estadísticas
     long total_produced = 0;
     long total_consumed = 0;
     long wait_full = 0;        // Veces que productores esperaron
     long wait_empty = 0;       // Veces que consumidores esperaron
+    
+    Ring() = default;
+    Ring(const Ring&) = delete;
+    Ring& operator=(const Ring&) = delete;
+    
+    // Destruir los elementos que quedaron sin consumir
+    ~Ring() {
+        while (count > 0) {
+            slot(tail)->~T();
+            tail = (tail + 1) & MASK;
+            count--;
+        }
+    }
+    
+    T* slot(std::size_t i) {
+        return std::launder(reinterpret_cast<T*>(buf[i].bytes));
+    }
 };
 
+// Avisar al selector asociado (fuera del mutex; syscall solo si hay quien espere)
+template <class T, std::size_t N>
+void ring_notify_selector(Ring<T, N>* r) {
+    if (r->selector) r->selector->ready.notify();
+}
+
 /**
- * Insertar elemento en la cola (productor)
- * Bloquea si la cola está llena hasta que haya espacio
+ * Construir un elemento en el lugar con plazo (productor)
+ * Espera mientras la cola está llena hasta deadline_ns (CLOCK_MONOTONIC);
+ * RING_NO_WAIT no espera y RING_FOREVER espera sin límite.
+ * El elemento solo se construye si se inserta
  */
-void ring_push(Ring* r, int value) {
+template <class T, std::size_t N, class... Args>
+RingStatus ring_emplace_until(Ring<T, N>* r, uint64_t deadline_ns, Args&&... args) {
     pthread_mutex_lock(&r->mutex);
     
-    // Esperar hasta que haya espacio O se active stop
-    while (r->count == QUEUE_SIZE && !r->stop) {
+    // Esperar hasta que haya espacio O se active stop O venza el plazo
+    while (r->count == N && !r->stop) {
+        if (deadline_ns == RING_NO_WAIT ||
+            (deadline_ns != RING_FOREVER && now_ns() >= deadline_ns)) {
+            pthread_mutex_unlock(&r->mutex);
+            return RING_AGAIN;
+        }
         r->wait_full++;
-        pthread_cond_wait(&r->not_full, &r->mutex);
+        ring_cond_wait(&r->not_full, &r->mutex, deadline_ns);
     }
     
     // Solo insertar si no estamos en shutdown
-    if (!r->stop) {
-        r->buf[r->head] = value;
-        r->head = (r->head + 1) % QUEUE_SIZE;
-        r->count++;
-        r->total_produced++;
-        
-        // Despertar a consumidores esperando
-        pthread_cond_signal(&r->not_empty);
+    if (r->stop) {
+        pthread_mutex_unlock(&r->mutex);
+        return RING_CLOSED;
     }
     
+    new (r->buf[r->head].bytes) T(std::forward<Args>(args)...);
+    r->head = (r->head + 1) & Ring<T, N>::MASK;
+    r->count++;
+    r->total_produced++;
+    
+    // Despertar a consumidores esperando
+    pthread_cond_signal(&r->not_empty);
     pthread_mutex_unlock(&r->mutex);
+    ring_notify_selector(r);
+    return RING_OK;
 }
 
 /**
- * Extraer elemento de la cola (consumidor)
- * Retorna false si la cola está vacía y se activó stop
+ * Construir un elemento en el lugar (productor)
+ * Bloquea si la cola está llena hasta que haya espacio
+ */
+template <class T, std::size_t N, class... Args>
+void ring_emplace(Ring<T, N>* r, Args&&... args) {
+    ring_emplace_until(r, RING_FOREVER, std::forward<Args>(args)...);
+}
+
+/**
+ * Insertar elemento en la cola (productor)
+ * Copia desde un lvalue, mueve desde un rvalue
+ */
+template <class T, std::size_t N>
+void ring_push(Ring<T, N>* r, const T& value) {
+    ring_emplace(r, value);
+}
+
+template <class T, std::size_t N>
+void ring_push(Ring<T, N>* r, T&& value) {
+    ring_emplace(r, std::move(value));
+}
+
+// Insertar sin esperar; si no hay espacio value queda intacto
+template <class T, std::size_t N, class U>
+RingStatus ring_try_push(Ring<T, N>* r, U&& value) {
+    return ring_emplace_until(r, RING_NO_WAIT, std::forward<U>(value));
+}
+
+template <class T, std::size_t N, class U>
+RingStatus ring_push_until(Ring<T, N>* r, U&& value, uint64_t deadline_ns) {
+    return ring_emplace_until(r, deadline_ns, std::forward<U>(value));
+}
+
+/**
+ * Extraer elemento con plazo (consumidor)
+ * Mueve el elemento a *output y destruye la ranura
+ * RING_CLOSED si la cola está vacía y se activó stop
  */
-bool ring_pop(Ring* r, int* output) {
+template <class T, std::size_t N>
+RingStatus ring_pop_until(Ring<T, N>* r, T* output, uint64_t deadline_ns) {
     pthread_mutex_lock(&r->mutex);
     
-    // Esperar hasta que haya elementos O se active stop
+    // Esperar hasta que haya elementos O se active stop O venza el plazo
     while (r->count == 0 && !r->stop) {
+        if (deadline_ns == RING_NO_WAIT ||
+            (deadline_ns != RING_FOREVER && now_ns() >= deadline_ns)) {
+            pthread_mutex_unlock(&r->mutex);
+            return RING_AGAIN;
+        }
         r->wait_empty++;
-        pthread_cond_wait(&r->not_empty, &r->mutex);
+        ring_cond_wait(&r->not_empty, &r->mutex, deadline_ns);
     }
     
     // Si no hay elementos y estamos en shutdown, terminar
     if (r->count == 0 && r->stop) {
         pthread_mutex_unlock(&r->mutex);
-        return false;
+        return RING_CLOSED;
     }
     
     // Extraer elemento
-    *output = r->buf[r->tail];
-    r->tail = (r->tail + 1) % QUEUE_SIZE;
+    T* item = r->slot(r->tail);
+    *output = std::move(*item);
+    item->~T();
+    r->tail = (r->tail + 1) & Ring<T, N>::MASK;
     r->count--;
     r->total_consumed++;
     
@@ -93,161 +253,1827 @@ bool ring_pop(Ring* r, int* output) {
     pthread_cond_signal(&r->not_full);
     
     pthread_mutex_unlock(&r->mutex);
-    return true;
+    return RING_OK;
+}
+
+/**
+ * Extraer elemento de la cola (consumidor)
+ * Retorna false si la cola está vacía y se activó stop
+ */
+template <class T, std::size_t N>
+bool ring_pop(Ring<T, N>* r, T* output) {
+    return ring_pop_until(r, output, RING_FOREVER) == RING_OK;
+}
+
+template <class T, std::size_t N>
+RingStatus ring_try_pop(Ring<T, N>* r, T* output) {
+    return ring_pop_until(r, output, RING_NO_WAIT);
+}
+
+/**
+ * Insertar n elementos (productor por lotes)
+ * Cada adquisición del mutex mueve tantos elementos como quepan,
+ * con una sola señal a consumidores por tramo insertado
+ */
+template <class T, std::size_t N>
+void ring_push_n(Ring<T, N>* r, const T* values, std::size_t n) {
+    std::size_t done = 0;
+    
+    while (done < n) {
+        pthread_mutex_lock(&r->mutex);
+        
+        while (r->count == N && !r->stop) {
+            r->wait_full++;
+            pthread_cond_wait(&r->not_full, &r->mutex);
+        }
+        
+        if (r->stop) {
+            pthread_mutex_unlock(&r->mutex);
+            return;
+        }
+        
+        std::size_t k = std::min(n - done, N - r->count);
+        for (std::size_t j = 0; j < k; j++) {
+            new (r->buf[r->head].bytes) T(values[done + j]);
+            r->head = (r->head + 1) & Ring<T, N>::MASK;
+        }
+        r->count += k;
+        r->total_produced += k;
+        done += k;
+        
+        // Una sola señal por tramo; el consumidor encadena si quedan elementos
+        pthread_cond_signal(&r->not_empty);
+        pthread_mutex_unlock(&r->mutex);
+        ring_notify_selector(r);
+    }
+}
+
+/**
+ * Extraer hasta max elementos (consumidor por lotes)
+ * Bloquea hasta que haya al menos uno; retorna cuántos extrajo
+ * (0 si la cola está vacía y se activó stop)
+ */
+template <class T, std::size_t N>
+std::size_t ring_pop_n(Ring<T, N>* r, T* output, std::size_t max) {
+    pthread_mutex_lock(&r->mutex);
+    
+    while (r->count == 0 && !r->stop) {
+        r->wait_empty++;
+        pthread_cond_wait(&r->not_empty, &r->mutex);
+    }
+    
+    std::size_t k = std::min(max, r->count);
+    for (std::size_t j = 0; j < k; j++) {
+        T* item = r->slot(r->tail);
+        output[j] = std::move(*item);
+        item->~T();
+        r->tail = (r->tail + 1) & Ring<T, N>::MASK;
+    }
+    r->count -= k;
+    r->total_consumed += k;
+    
+    if (k > 0) {
+        pthread_cond_signal(&r->not_full);
+    }
+    // Encadenar: si quedan elementos, despertar a otro consumidor
+    if (r->count > 0) {
+        pthread_cond_signal(&r->not_empty);
+    }
+    
+    pthread_mutex_unlock(&r->mutex);
+    return k;
+}
+
+// Versión genérica por lotes para colas sin implementación propia
+template <class Q, class T>
+void ring_push_n(Q* r, const T* values, std::size_t n) {
+    for (std::size_t j = 0; j < n; j++) {
+        ring_push(r, values[j]);
+    }
+}
+
+template <class Q, class T>
+std::size_t ring_pop_n(Q* r, T* output, std::size_t max) {
+    if (max == 0 || !ring_pop(r, &output[0])) return 0;
+    return 1;
 }
 
 /**
- * Iniciar shutdown graceful
- * Despierta a todos los hilos esperando
+ * Cerrar la cola (shutdown graceful)
+ * Despierta a todos los hilos esperando; los push posteriores se descartan
+ * y ring_pop sigue entregando lo que quede hasta verla cerrada y vacía
  */
-void ring_shutdown(Ring* r) {
+template <class T, std::size_t N>
+void ring_shutdown(Ring<T, N>* r) {
     pthread_mutex_lock(&r->mutex);
     r->stop = true;
     pthread_cond_broadcast(&r->not_full);
     pthread_cond_broadcast(&r->not_empty);
     pthread_mutex_unlock(&r->mutex);
+    ring_notify_selector(r);
+}
+
+constexpr int RING_SELECT_TIMEOUT = -1;
+constexpr int RING_SELECT_CLOSED = -2;
+
+/**
+ * Esperar a que alguna de las n colas tenga elementos
+ * Retorna el índice de la primera lista (recorriendo en rueda desde la
+ * última elegida, para no dejar colas sin atender), RING_SELECT_CLOSED si
+ * todas están cerradas y vacías, o RING_SELECT_TIMEOUT si vence el plazo.
+ * Las colas deben tener r->selector = sel. Otro consumidor puede vaciar la
+ * cola elegida antes del pop: usar ring_try_pop y volver a seleccionar.
+ */
+template <class T, std::size_t N>
+int ring_select(RingSelector* sel, Ring<T, N>* const* rings, std::size_t n,
+                uint64_t deadline_ns) {
+    for (;;) {
+        // Registrarse antes de revisar: un push posterior cambia la palabra del futex
+        uint32_t key = sel->ready.prepare_wait();
+        std::size_t start = sel->next.load(std::memory_order_relaxed);
+        bool all_closed = true;
+        
+        for (std::size_t k = 0; k < n; k++) {
+            std::size_t i = (start + k) % n;
+            pthread_mutex_lock(&rings[i]->mutex);
+            bool ready = rings[i]->count > 0;
+            bool closed = rings[i]->stop && !ready;
+            pthread_mutex_unlock(&rings[i]->mutex);
+            
+            if (ready) {
+                sel->ready.cancel_wait();
+                sel->next.store((i + 1) % n, std::memory_order_relaxed);
+                return static_cast<int>(i);
+            }
+            all_closed = all_closed && closed;
+        }
+        
+        if (all_closed || deadline_ns == RING_NO_WAIT) {
+            sel->ready.cancel_wait();
+            return all_closed ? RING_SELECT_CLOSED : RING_SELECT_TIMEOUT;
+        }
+        if (deadline_ns == RING_FOREVER) {
+            sel->ready.wait(key);
+        } else if (!sel->ready.wait_until(key, deadline_ns)) {
+            return RING_SELECT_TIMEOUT;
+        }
+    }
 }
 
-void ring_destroy(Ring* r) {
+template <class T, std::size_t N>
+void ring_destroy(Ring<T, N>* r) {
     pthread_mutex_destroy(&r->mutex);
     pthread_cond_destroy(&r->not_full);
     pthread_cond_destroy(&r->not_empty);
 }
 
+/**
+ * Ring con espera por futex (EventCount) en lugar de condvars
+ * El mutex solo protege los datos; la espera ocurre fuera del lock:
+ * gira FUTEX_SPIN vueltas leyendo count y luego duerme en el eventcount.
+ * Notificar tras cada push/pop solo hace syscall si hay hilos registrados.
+ */
+constexpr int FUTEX_SPIN = 256;
+
+template <class T, std::size_t Capacity = QUEUE_SIZE>
+struct FutexRing {
+    using value_type = T;
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0,
+                  "Capacity debe ser potencia de dos");
+    static constexpr std::size_t MASK = Capacity - 1;
+    
+    typename Ring<T, Capacity>::Slot buf[Capacity];
+    std::size_t head = 0;
+    std::size_t tail = 0;
+    std::atomic<std::size_t> count{0};   // Se escribe con mutex, se lee al girar
+    std::atomic<bool> stop{false};
+    
+    pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+    EventCount not_full;
+    EventCount not_empty;
+    
+    // Estadísticas (protegidas por mutex)
+    long total_produced = 0;
+    long total_consumed = 0;
+    long wait_full = 0;
+    long wait_empty = 0;
+    
+    FutexRing() = default;
+    FutexRing(const FutexRing&) = delete;
+    FutexRing& operator=(const FutexRing&) = delete;
+    
+    ~FutexRing() {
+        while (count.load() > 0) {
+            slot(tail)->~T();
+            tail = (tail + 1) & MASK;
+            count.store(count.load() - 1);
+        }
+    }
+    
+    T* slot(std::size_t i) {
+        return std::launder(reinterpret_cast<T*>(buf[i].bytes));
+    }
+};
+
+template <class T, std::size_t N>
+void ring_push(FutexRing<T, N>* r, T value) {
+    pthread_mutex_lock(&r->mutex);
+    
+    while (r->count.load(std::memory_order_relaxed) == N && !r->stop.load()) {
+        r->wait_full++;
+        pthread_mutex_unlock(&r->mutex);
+        r->not_full.await([r] {
+            return r->count.load(std::memory_order_acquire) < N ||
+                   r->stop.load(std::memory_order_acquire);
+        }, FUTEX_SPIN);
+        pthread_mutex_lock(&r->mutex);
+    }
+    
+    bool inserted = false;
+    if (!r->stop.load()) {
+        new (r->buf[r->head].bytes) T(std::move(value));
+        r->head = (r->head + 1) & FutexRing<T, N>::MASK;
+        r->count.store(r->count.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        r->total_produced++;
+        inserted = true;
+    }
+    
+    pthread_mutex_unlock(&r->mutex);
+    if (inserted) {
+        r->not_empty.notify();  // Syscall solo si hay consumidores dormidos
+    }
+}
+
+template <class T, std::size_t N>
+bool ring_pop(FutexRing<T, N>* r, T* output) {
+    pthread_mutex_lock(&r->mutex);
+    
+    while (r->count.load(std::memory_order_relaxed) == 0 && !r->stop.load()) {
+        r->wait_empty++;
+        pthread_mutex_unlock(&r->mutex);
+        r->not_empty.await([r] {
+            return r->count.load(std::memory_order_acquire) > 0 ||
+                   r->stop.load(std::memory_order_acquire);
+        }, FUTEX_SPIN);
+        pthread_mutex_lock(&r->mutex);
+    }
+    
+    if (r->count.load(std::memory_order_relaxed) == 0) {
+        pthread_mutex_unlock(&r->mutex);
+        return false;  // Vacía y stop
+    }
+    
+    T* item = r->slot(r->tail);
+    *output = std::move(*item);
+    item->~T();
+    r->tail = (r->tail + 1) & FutexRing<T, N>::MASK;
+    r->count.store(r->count.load(std::memory_order_relaxed) - 1, std::memory_order_release);
+    r->total_consumed++;
+    
+    pthread_mutex_unlock(&r->mutex);
+    r->not_full.notify();  // Syscall solo si hay productores dormidos
+    return true;
+}
+
+template <class T, std::size_t N>
+void ring_shutdown(FutexRing<T, N>* r) {
+    pthread_mutex_lock(&r->mutex);
+    r->stop.store(true);
+    pthread_mutex_unlock(&r->mutex);
+    r->not_full.notify();
+    r->not_empty.notify();
+}
+
+template <class T, std::size_t N>
+void ring_destroy(FutexRing<T, N>* r) {
+    pthread_mutex_destroy(&r->mutex);
+}
+
+/**
+ * Cola de bytes para mensajes de largo variable, sin copias intermedias
+ * Un productor y un consumidor (SPSC, lock-free como SpscRing):
+ *   p = byte_ring_reserve(r, len);  escribir en p;  byte_ring_commit(r);
+ *   byte_ring_peek(r, &view);       leer view;      byte_ring_release(r);
+ * Cada mensaje es un registro {cabecera de 8 bytes, datos} alineado a 8.
+ * Un registro nunca se parte: si no cabe antes del final del buffer, el
+ * resto del buffer se marca con un registro de relleno y el mensaje
+ * empieza en la posición 0. El mensaje máximo es Capacity / 2 - 8 bytes.
+ */
+constexpr std::size_t BYTE_RING_SIZE = 1 << 20;   // 1 MB: admite mensajes de 64 KB
+
+template <std::size_t Capacity = BYTE_RING_SIZE>
+struct ByteRing {
+    static_assert(Capacity >= 64 && (Capacity & (Capacity - 1)) == 0,
+                  "Capacity debe ser potencia de dos");
+    static constexpr std::size_t MASK = Capacity - 1;
+    static constexpr std::size_t ALIGN = 8;
+    static constexpr std::size_t MAX_MESSAGE = Capacity / 2 - sizeof(uint64_t);
+    static constexpr uint32_t PADDING = 0xffffffffu;   // len de un registro de relleno
+    
+    struct Header {
+        uint32_t len;      // Bytes de datos, o PADDING
+        uint32_t seq;      // Número de mensaje, para verificar el orden
+    };
+    static_assert(sizeof(Header) == ALIGN, "la cabecera ocupa una unidad de alineación");
+    
+    // Línea del productor
+    alignas(CACHE_LINE) std::atomic<std::size_t> head{0};
+    std::size_t cached_tail = 0;
+    std::size_t reserved_pos = 0;    // Inicio del registro reservado
+    std::size_t reserved_pad = 0;    // Relleno que precede a la reserva
+    std::size_t reserved_len = 0;
+    uint32_t next_seq = 0;
+    long messages = 0;
+    long bytes = 0;
+    long paddings = 0;
+    long wait_full = 0;
+    
+    // Línea del consumidor
+    alignas(CACHE_LINE) std::atomic<std::size_t> tail{0};
+    std::size_t cached_head = 0;
+    std::size_t peeked_size = 0;     // Tamaño del registro entregado por peek
+    long wait_empty = 0;
+    
+    alignas(CACHE_LINE) std::atomic<bool> stop{false};
+    alignas(CACHE_LINE) EventCount not_full;
+    alignas(CACHE_LINE) EventCount not_empty;
+    
+    alignas(CACHE_LINE) unsigned char buf[Capacity];
+    
+    static std::size_t record_size(std::size_t len) {
+        return (sizeof(Header) + len + ALIGN - 1) & ~(ALIGN - 1);
+    }
+    
+    Header* header_at(std::size_t pos) {
+        return reinterpret_cast<Header*>(&buf[pos & MASK]);
+    }
+};
+
+/**
+ * Reservar len bytes contiguos para escribir un mensaje en el lugar
+ * Bloquea mientras no hay espacio; retorna nullptr si se activó stop
+ * o len supera MAX_MESSAGE
+ */
+template <std::size_t N>
+unsigned char* byte_ring_reserve(ByteRing<N>* r, std::size_t len) {
+    using B = ByteRing<N>;
+    if (len > B::MAX_MESSAGE) return nullptr;
+    
+    std::size_t h = r->head.load(std::memory_order_relaxed);
+    std::size_t size = B::record_size(len);
+    std::size_t to_end = N - (h & B::MASK);
+    std::size_t pad = size > to_end ? to_end : 0;   // No cabe: rellenar hasta el final
+    std::size_t need = pad + size;
+    
+    if (N - (h - r->cached_tail) < need) {
+        r->cached_tail = r->tail.load(std::memory_order_acquire);
+        if (N - (h - r->cached_tail) < need) {
+            r->wait_full++;
+            r->not_full.await([r, h, need] {
+                r->cached_tail = r->tail.load(std::memory_order_acquire);
+                return N - (h - r->cached_tail) >= need || r->stop.load(std::memory_order_acquire);
+            });
+            if (N - (h - r->cached_tail) < need) return nullptr;  // stop
+        }
+    }
+    
+    r->reserved_pos = h + pad;
+    r->reserved_pad = pad;
+    r->reserved_len = len;
+    return r->buf + ((h + pad) & B::MASK) + sizeof(typename B::Header);
+}
+
+/**
+ * Publicar el mensaje reservado (con el relleno que lo preceda)
+ * len opcional: puede ser menor que lo reservado si se escribió menos
+ */
+template <std::size_t N>
+void byte_ring_commit(ByteRing<N>* r, std::size_t len = SIZE_MAX) {
+    using B = ByteRing<N>;
+    if (len > r->reserved_len) len = r->reserved_len;
+    
+    std::size_t h = r->head.load(std::memory_order_relaxed);
+    if (r->reserved_pad > 0) {
+        r->header_at(h)->len = B::PADDING;
+        r->paddings++;
+    }
+    auto* hdr = r->header_at(r->reserved_pos);
+    hdr->len = static_cast<uint32_t>(len);
+    hdr->seq = r->next_seq++;
+    
+    // Relleno, cabecera y datos quedan visibles con un solo store
+    r->head.store(r->reserved_pos + B::record_size(len), std::memory_order_release);
+    r->messages++;
+    r->bytes += static_cast<long>(len);
+    r->not_empty.notify();
+}
+
+// Vista de un mensaje dentro del buffer; válida hasta byte_ring_release()
+struct ByteView {
+    const unsigned char* data;
+    std::size_t len;
+    uint32_t seq;
+};
+
+/**
+ * Obtener el siguiente mensaje sin copiarlo (salta registros de relleno)
+ * Retorna false si la cola está vacía y se activó stop
+ */
+template <std::size_t N>
+bool byte_ring_peek(ByteRing<N>* r, ByteView* view) {
+    using B = ByteRing<N>;
+    std::size_t t = r->tail.load(std::memory_order_relaxed);
+    
+    for (;;) {
+        if (t == r->cached_head) {
+            r->cached_head = r->head.load(std::memory_order_acquire);
+            if (t == r->cached_head) {
+                r->wait_empty++;
+                r->not_empty.await([r, t] {
+                    bool stopped = r->stop.load(std::memory_order_acquire);
+                    r->cached_head = r->head.load(std::memory_order_acquire);
+                    return t != r->cached_head || stopped;
+                });
+                if (t == r->cached_head) return false;  // Vacía y stop
+            }
+        }
+        
+        auto* hdr = r->header_at(t);
+        if (hdr->len == B::PADDING) {
+            // Saltar hasta el inicio del buffer y liberar el relleno
+            t += N - (t & B::MASK);
+            r->tail.store(t, std::memory_order_release);
+            r->not_full.notify();
+            continue;
+        }
+        
+        view->data = reinterpret_cast<const unsigned char*>(hdr + 1);
+        view->len = hdr->len;
+        view->seq = hdr->seq;
+        r->peeked_size = B::record_size(hdr->len);
+        return true;
+    }
+}
+
+// Liberar el mensaje entregado por el último peek
+template <std::size_t N>
+void byte_ring_release(ByteRing<N>* r) {
+    std::size_t t = r->tail.load(std::memory_order_relaxed);
+    r->tail.store(t + r->peeked_size, std::memory_order_release);
+    r->peeked_size = 0;
+    r->not_full.notify();
+}
+
+template <std::size_t N>
+void byte_ring_shutdown(ByteRing<N>* r) {
+    r->stop.store(true, std::memory_order_release);
+    r->not_full.notify();
+    r->not_empty.notify();
+}
+
+/**
+ * Registro de cada hilo en la cola antes de operar
+ * Solo las colas repartidas (StealQueue) lo usan para elegir su cola casa
+ */
+template <class Q> void ring_attach_producer(Q*, int) {}
+template <class Q> void ring_attach_consumer(Q*, int) {}
+
+// Estadísticas comunes a todas las colas, leídas al terminar
+struct RingStats {
+    long produced;
+    long consumed;
+    long wait_full;
+    long wait_empty;
+    std::size_t count;     // Elementos que quedaron en la cola
+};
+
+template <class T, std::size_t N>
+RingStats ring_stats(const Ring<T, N>* r) {
+    return {r->total_produced, r->total_consumed, r->wait_full, r->wait_empty, r->count};
+}
+
+template <class T, std::size_t N>
+RingStats ring_stats(const FutexRing<T, N>* r) {
+    return {r->total_produced, r->total_consumed, r->wait_full, r->wait_empty, r->count.load()};
+}
+
+template <std::size_t N, class T>
+RingStats ring_stats(const SpscRing<N, T>* r) {
+    return {r->total_produced, r->total_consumed, r->wait_full, r->wait_empty, r->count()};
+}
+
+// En MPMC los tickets son los contadores: no hay contadores compartidos extra
+template <std::size_t N, class T>
+RingStats ring_stats(const MpmcQueue<N, T>* q) {
+    long produced = static_cast<long>(q->enqueue_pos.load());
+    long consumed = static_cast<long>(q->dequeue_pos.load());
+    return {produced, consumed, q->wait_full.load(), q->wait_empty.load(),
+            static_cast<std::size_t>(produced - consumed)};
+}
+
+template <std::size_t N, class T>
+RingStats ring_stats(const StealQueue<N, T>* q) {
+    long produced = 0;
+    long consumed = 0;
+    for (const auto& s : q->shards) {
+        produced += static_cast<long>(s->enqueue_pos.load());
+        consumed += static_cast<long>(s->dequeue_pos.load());
+    }
+    return {produced, consumed, q->wait_full.load(), q->wait_empty.load(),
+            static_cast<std::size_t>(produced - consumed)};
+}
+
+template <class T, std::size_t N>
+RingStats ring_stats(const SegmentedQueue<T, N>* q) {
+    return {q->total_produced, q->total_consumed, q->wait_full, q->wait_empty, q->count};
+}
+
+constexpr int ITEM_ID_STRIDE = 1000000;  // valor = id * STRIDE + i
+
+// Opciones de ejecución compartidas por productores y consumidores
+struct RunOptions {
+    int batch = 1;             // Elementos por push_n / pop_n
+    bool batched = false;      // -b dado: usar API por lotes
+    bool latency = false;      // -l dado: items con marca de tiempo + histograma
+    double rate = 0;           // -r: elementos/segundo en total (lazo abierto), 0 = sin límite
+    int shards = 0;            // -q: colas del modo steal (0 = una por productor)
+    unsigned idle_ms = 200;    // -i: inactividad antes de liberar segmentos del pool
+    bool check_order = true;   // Verificar FIFO por productor (ids sin solaparse)
+};
+
+/**
+ * Elemento con marca de tiempo de encolado (modo -l)
+ * El consumidor registra now_ns() - enqueue_ns en su histograma
+ */
+struct TimedItem {
+    int value;
+    uint64_t enqueue_ns;
+};
+
+// stamp_ns: instante desde el que se mide la latencia (0 = ahora)
+template <class T> T make_item(int value, uint64_t stamp_ns = 0);
+template <> int make_item<int>(int value, uint64_t) { return value; }
+template <> TimedItem make_item<TimedItem>(int value, uint64_t stamp_ns) {
+    return {value, stamp_ns ? stamp_ns : now_ns()};
+}
+
+// Dormir hasta un instante absoluto de CLOCK_MONOTONIC
+inline void sleep_until_ns(uint64_t deadline_ns) {
+    timespec ts;
+    ts.tv_sec = static_cast<time_t>(deadline_ns / 1000000000ULL);
+    ts.tv_nsec = static_cast<long>(deadline_ns % 1000000000ULL);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR) {
+    }
+}
+
+inline int item_value(int v) { return v; }
+inline int item_value(const TimedItem& item) { return item.value; }
+
+/**
+ * Verifica que un consumidor vea los elementos de cada productor en el
+ * orden en que se insertaron (valor = productor * STRIDE + secuencia)
+ */
+struct OrderCheck {
+    std::vector<int> last;   // Último valor visto de cada productor
+    long inversions = 0;
+
+    void see(int value) {
+        std::size_t producer = static_cast<std::size_t>(value / ITEM_ID_STRIDE);
+        if (producer >= last.size()) last.resize(producer + 1, -1);
+        if (value < last[producer]) inversions++;
+        last[producer] = value;
+    }
+};
+
+inline void record_latency(LatencyHistogram*, const int&, uint64_t) {}
+inline void record_latency(LatencyHistogram* h, const TimedItem& item, uint64_t now) {
+    h->record(now - item.enqueue_ns);
+}
+
+template <class Q>
 struct ThreadArgs {
-    Ring* ring;
+    Q* ring;
     int thread_id;
     long iterations;
     double* thread_time;
+    const RunOptions* opts;
+    LatencyHistogram* latency;   // Histograma propio del consumidor (modo -l)
+    std::atomic<int>* producers_left;   // El último productor en terminar cierra la cola
+    uint64_t* last_consume_ns;          // Instante del último elemento de cada consumidor
+    long* order_inversions;             // Inversiones FIFO por productor de cada consumidor
+    uint64_t schedule_start_ns;         // Lazo abierto: inicio común del calendario
+    double interval_ns;                 // Lazo abierto: separación entre envíos (0 = sin límite)
+    uint64_t* send_lag_ns;              // Mayor atraso del productor respecto al calendario
 };
 
 // Hilo productor
+template <class Q>
 void* producer_thread(void* arg) {
-    auto* args = static_cast<ThreadArgs*>(arg);
-    Ring* r = args->ring;
+    using T = typename Q::value_type;
+    auto* args = static_cast<ThreadArgs<Q>*>(arg);
+    Q* r = args->ring;
     int id = args->thread_id;
     long iters = args->iterations;
     
+    ring_attach_producer(r, id);
     double start = now_s();
     
-    for (long i = 0; i < iters; i++) {
-        int value = id * 1000000 + i;  // Valor único por hilo
-        ring_push(r, value);
+    if (args->opts->batched) {
+        // Acumular un lote local y publicarlo con una sola operación
+        std::vector<T> batch(args->opts->batch);
+        std::size_t fill = 0;
         
-        // Simular trabajo de producción
-        if (i % 10000 == 0) {
-            usleep(1);  // 1 microsegundo cada 10k items
+        for (long i = 0; i < iters; i++) {
+            batch[fill++] = make_item<T>(id * ITEM_ID_STRIDE + i);
+            if (fill == batch.size() || i == iters - 1) {
+                ring_push_n(r, batch.data(), fill);
+                fill = 0;
+            }
+            
+            if (i % 10000 == 0) {
+                usleep(1);
+            }
+        }
+    } else if (args->interval_ns > 0) {
+        // Lazo abierto: el elemento i está programado en start + i * intervalo,
+        // sin importar cuánto tardó el anterior. Si el productor se atrasa
+        // (cola llena) envía de inmediato, pero la latencia se mide desde el
+        // instante programado: la espera en el productor cuenta (sin omisión
+        // coordinada)
+        uint64_t max_lag = 0;
+        for (long i = 0; i < iters; i++) {
+            uint64_t scheduled = args->schedule_start_ns +
+                                 static_cast<uint64_t>(i * args->interval_ns);
+            uint64_t now = now_ns();
+            if (now < scheduled) {
+                sleep_until_ns(scheduled);
+            } else if (now - scheduled > max_lag) {
+                max_lag = now - scheduled;
+            }
+            ring_push(r, make_item<T>(id * ITEM_ID_STRIDE + i, scheduled));
+        }
+        args->send_lag_ns[id] = max_lag;
+    } else {
+        for (long i = 0; i < iters; i++) {
+            T value = make_item<T>(id * ITEM_ID_STRIDE + i);  // Valor único por hilo
+            ring_push(r, value);
+            
+            // Simular trabajo de producción
+            if (i % 10000 == 0) {
+                usleep(1);  // 1 microsegundo cada 10k items
+            }
         }
     }
     
     double end = now_s();
     args->thread_time[id] = end - start;
     
+    // Cierre: ya no habrá más push; los consumidores drenan y salen
+    if (args->producers_left->fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        ring_shutdown(r);
+    }
+    
     printf("Productor %d terminó: %ld elementos en %.4fs\n", 
            id, iters, end - start);
     return nullptr;
 }
 
 // Hilo consumidor
+template <class Q>
 void* consumer_thread(void* arg) {
-    auto* args = static_cast<ThreadArgs*>(arg);
-    Ring* r = args->ring;
+    using T = typename Q::value_type;
+    auto* args = static_cast<ThreadArgs<Q>*>(arg);
+    Q* r = args->ring;
     int id = args->thread_id;
     
+    ring_attach_consumer(r, id);
     double start = now_s();
     long consumed = 0;
-    int value;
+    uint64_t last_ns = 0;
+    bool check = args->opts->check_order;
+    OrderCheck order;
+    T value{};
     
-    while (ring_pop(r, &value)) {
-        consumed++;
+    if (args->opts->batched) {
+        std::vector<T> batch(args->opts->batch);
+        std::size_t k;
         
-        // Simular trabajo de consumo
-        if (consumed % 10000 == 0) {
-            usleep(1);  // 1 microsegundo cada 10k items
+        while ((k = ring_pop_n(r, batch.data(), batch.size())) > 0) {
+            last_ns = now_ns();
+            for (std::size_t j = 0; j < k; j++) {
+                record_latency(args->latency, batch[j], last_ns);
+                if (check) order.see(item_value(batch[j]));
+                
+                if (++consumed % 10000 == 0) {
+                    usleep(1);
+                }
+            }
+        }
+    } else {
+        while (ring_pop(r, &value)) {
+            last_ns = now_ns();
+            record_latency(args->latency, value, last_ns);
+            if (check) order.see(item_value(value));
+            consumed++;
+            
+            // Simular trabajo de consumo
+            if (consumed % 10000 == 0) {
+                usleep(1);  // 1 microsegundo cada 10k items
+            }
         }
     }
     
     double end = now_s();
     args->thread_time[id] = end - start;
+    args->last_consume_ns[id] = last_ns;
+    args->order_inversions[id] = order.inversions;
     
     printf("Consumidor %d terminó: %ld elementos en %.4fs\n", 
            id, consumed, end - start);
     return nullptr;
 }
 
-int main(int argc, char** argv) {
-    int producers = (argc > 1) ? std::atoi(argv[1]) : 2;
-    int consumers = (argc > 2) ? std::atoi(argv[2]) : 2;
-    long items_per_producer = (argc > 3) ? std::atol(argv[3]) : 100000;
-    
-    printf("Laboratorio 6 - Práctica 2: Buffer Circular\n");
-    printf("Configuración: %d productores, %d consumidores\n", producers, consumers);
-    printf("Items por productor: %ld (total: %ld)\n", 
-           items_per_producer, items_per_producer * producers);
-    
-    Ring ring;
-    
+// Detalle de espera propio de cada cola (por defecto nada)
+template <class Q>
+void print_wait_details(const Q*) {}
+
+/**
+ * Syscalls de futex: cada push/pop notifica al otro lado, pero solo hay
+ * FUTEX_WAKE si alguien estaba registrado; el resto son syscalls evitadas
+ */
+void print_futex_stats(const EventCount& not_full, const EventCount& not_empty,
+                       long notifies) {
+    long wakes = not_full.wake_syscalls() + not_empty.wake_syscalls();
+    long waits = not_full.wait_syscalls() + not_empty.wait_syscalls();
+    printf("Syscalls futex: %ld wake + %ld wait\n", wakes, waits);
+    printf("Syscalls evitadas (notificaciones sin esperas): %ld de %ld\n",
+           notifies - wakes, notifies);
+}
+
+template <class T, std::size_t N>
+void print_wait_details(const FutexRing<T, N>* r) {
+    print_futex_stats(r->not_full, r->not_empty, r->total_produced + r->total_consumed);
+}
+
+template <std::size_t N, class T>
+void print_wait_details(const SpscRing<N, T>* r) {
+    print_futex_stats(r->not_full, r->not_empty, r->total_produced + r->total_consumed);
+}
+
+template <std::size_t N, class T>
+void print_wait_details(const MpmcQueue<N, T>* q) {
+    printf("Productores durmieron (tras girar): %ld veces\n", q->park_full.load());
+    printf("Consumidores durmieron (tras girar): %ld veces\n", q->park_empty.load());
+    printf("Límite de giro adaptativo final: %d\n", q->spin_limit.load());
+    long ops = static_cast<long>(q->enqueue_pos.load() + q->dequeue_pos.load());
+    print_futex_stats(q->not_full, q->not_empty, ops);
+}
+
+template <std::size_t N, class T>
+void print_wait_details(const StealQueue<N, T>* q) {
+    long consumed = 0;
+    printf("Colas: %zu (capacidad %zu c/u)\n", q->size(), N);
+    printf("Extraídos por cola:");
+    for (const auto& s : q->shards) {
+        long c = static_cast<long>(s->dequeue_pos.load());
+        consumed += c;
+        printf(" %ld", c);
+    }
+    printf("\n");
+    long steals = q->steals.load();
+    printf("Robos: %ld (%.1f%% de las extracciones)\n",
+           steals, consumed > 0 ? 100.0 * steals / consumed : 0.0);
+    long ops = 0;
+    for (const auto& s : q->shards) {
+        ops += static_cast<long>(s->enqueue_pos.load() + s->dequeue_pos.load());
+    }
+    print_futex_stats(q->not_full, q->not_empty, ops);
+}
+
+template <class T, std::size_t N>
+void print_wait_details(const SegmentedQueue<T, N>* q) {
+    printf("Segmentos: %zu KB c/u, pico %zu (%zu KB), vivos al final %zu\n",
+           q->segment_bytes() / 1024, q->segments_peak,
+           q->segments_peak * q->segment_bytes() / 1024, q->segments_live);
+    printf("Segmentos mmap: %ld, reutilizados del pool: %ld, munmap: %ld\n",
+           q->segments_mapped, q->segments_reused, q->segments_unmapped);
+}
+
+/**
+ * Ejecuta productores y consumidores sobre una cola e imprime resultados
+ * Q es cualquier cola con ring_push/ring_pop/ring_shutdown/ring_count
+ */
+template <class Q>
+void run_ring(Q* ring, int producers, int consumers, long items_per_producer,
+              const RunOptions& opts) {
     std::vector<pthread_t> producer_threads(producers);
     std::vector<pthread_t> consumer_threads(consumers);
-    std::vector<ThreadArgs> producer_args(producers);
-    std::vector<ThreadArgs> consumer_args(consumers);
+    std::vector<ThreadArgs<Q>> producer_args(producers);
+    std::vector<ThreadArgs<Q>> consumer_args(consumers);
     std::vector<double> producer_times(producers);
     std::vector<double> consumer_times(consumers);
     
-    double start_time = now_s();
+    // Un histograma por consumidor; se combinan al final
+    std::vector<LatencyHistogram> latencies(consumers);
+    std::vector<uint64_t> last_consume(consumers, 0);
+    std::vector<long> inversions(consumers, 0);
+    std::atomic<int> producers_left{producers};
+    
+    std::vector<uint64_t> send_lag(producers, 0);
+    
+    // Lazo abierto: cada productor emite rate / P elementos por segundo,
+    // desfasados entre sí para repartir los envíos en el intervalo
+    double interval_ns = opts.rate > 0 ? 1e9 * producers / opts.rate : 0.0;
+    
+    uint64_t start_ns = now_ns();
+    if (producers == 0) {
+        ring_shutdown(ring);  // Nada que producir: cerrar de una vez
+    }
     
     // Crear productores
     for (int i = 0; i < producers; i++) {
-        producer_args[i] = {&ring, i, items_per_producer, producer_times.data()};
-        pthread_create(&producer_threads[i], nullptr, producer_thread, &producer_args[i]);
+        uint64_t phase_ns = static_cast<uint64_t>(interval_ns * i / producers);
+        producer_args[i] = {ring, i, items_per_producer, producer_times.data(),
+                            &opts, nullptr, &producers_left, nullptr, nullptr,
+                            start_ns + phase_ns, interval_ns, send_lag.data()};
+        pthread_create(&producer_threads[i], nullptr, producer_thread<Q>, &producer_args[i]);
     }
     
     // Crear consumidores
     for (int i = 0; i < consumers; i++) {
-        consumer_args[i] = {&ring, i, 0, consumer_times.data()};
-        pthread_create(&consumer_threads[i], nullptr, consumer_thread, &consumer_args[i]);
+        consumer_args[i] = {ring, i, 0, consumer_times.data(),
+                            &opts, &latencies[i], &producers_left, last_consume.data(),
+                            inversions.data(), 0, 0.0, nullptr};
+        pthread_create(&consumer_threads[i], nullptr, consumer_thread<Q>, &consumer_args[i]);
     }
     
-    // Esperar que terminen los productores
+    // El último productor cierra la cola; los consumidores salen al verla
+    // cerrada y vacía, así que no hace falta esperar un tiempo fijo
     for (int i = 0; i < producers; i++) {
         pthread_join(producer_threads[i], nullptr);
     }
-    
-    // Dar tiempo para que se procesen los elementos restantes
-    printf("Productores terminaron, esperando consumidores...\n");
-    sleep(1);
-    
-    // Iniciar shutdown
-    ring_shutdown(&ring);
-    
-    // Esperar que terminen los consumidores
     for (int i = 0; i < consumers; i++) {
         pthread_join(consumer_threads[i], nullptr);
     }
+    uint64_t join_ns = now_ns();
     
-    double total_time = now_s() - start_time;
+    // Fin = último elemento consumido (no incluye despertar y join de los hilos)
+    uint64_t end_ns = start_ns;
+    for (uint64_t t : last_consume) {
+        if (t > end_ns) end_ns = t;
+    }
+    double total_time = (end_ns - start_ns) * 1e-9;
+    RingStats st = ring_stats(ring);
     
     // Estadísticas finales
     printf("\n=== RESULTADOS ===\n");
     printf("Tiempo total: %.4f segundos\n", total_time);
-    printf("Elementos producidos: %ld\n", ring.total_produced);
-    printf("Elementos consumidos: %ld\n", ring.total_consumed);
-    printf("Elementos perdidos: %ld\n", ring.total_produced - ring.total_consumed);
-    printf("Elementos en cola: %zu\n", ring.count);
+    printf("Cierre de hilos tras último consumo: %.1f us\n", (join_ns - end_ns) / 1000.0);
+    printf("Elementos producidos: %ld\n", st.produced);
+    printf("Elementos consumidos: %ld\n", st.consumed);
+    printf("Elementos perdidos: %ld\n", st.produced - st.consumed);
+    printf("Elementos en cola: %zu\n", st.count);
     
     printf("\n=== ESTADÍSTICAS DE BLOQUEO ===\n");
-    printf("Productores esperaron (cola llena): %ld veces\n", ring.wait_full);
-    printf("Consumidores esperaron (cola vacía): %ld veces\n", ring.wait_empty);
+    printf("Productores esperaron (cola llena): %ld veces\n", st.wait_full);
+    printf("Consumidores esperaron (cola vacía): %ld veces\n", st.wait_empty);
+    print_wait_details(ring);
     
-    if (ring.total_consumed > 0) {
-        double throughput = ring.total_consumed / total_time;
+    if (st.consumed > 0 && total_time > 0) {
+        double throughput = st.consumed / total_time;
         printf("Throughput: %.0f elementos/segundo\n", throughput);
     }
+    if (opts.rate > 0) {
+        uint64_t max_lag = 0;
+        for (uint64_t lag : send_lag) max_lag = std::max(max_lag, lag);
+        printf("Tasa objetivo: %.0f elementos/segundo\n", opts.rate);
+        printf("Mayor atraso de un productor sobre su calendario: %.1f us\n", max_lag / 1000.0);
+    }
+    
+    if (opts.latency) {
+        LatencyHistogram merged;
+        for (const LatencyHistogram& h : latencies) {
+            merged.merge(h);
+        }
+        char label[96];
+        if (opts.rate > 0) {
+            snprintf(label, sizeof(label), "LATENCIA DESDE ENVÍO PROGRAMADO %dP/%dC tasa=%.0f/s",
+                     producers, consumers, opts.rate);
+        } else {
+            snprintf(label, sizeof(label), "LATENCIA ENCOLADO->DESENCOLADO %dP/%dC lote=%d",
+                     producers, consumers, opts.batch);
+        }
+        merged.print(label);
+    }
+    
+    if (opts.check_order) {
+        long total_inversions = 0;
+        for (long v : inversions) total_inversions += v;
+        printf("Orden FIFO por productor: %s (%ld inversiones)\n",
+               total_inversions == 0 ? "conservado" : "NO conservado", total_inversions);
+    }
     
     // Verificar corrección
-    bool correct = (ring.total_consumed == ring.total_produced) && (ring.count == 0);
+    bool correct = (st.consumed == st.produced) && (st.count == 0);
     printf("Corrección: %s\n", correct ? "CORRECTO" : "ERROR - pérdida de datos");
     
+    ring_destroy(ring);
+}
+
+// Tipos de carga para el modo payload
+struct Payload64 {
+    long id;
+    char data[56];
+};
+static_assert(sizeof(Payload64) == 64, "Payload64 debe ocupar 64 bytes");
+
+// Dueño de memoria en el heap: copiar reserva y copia 1 KB, mover solo roba el puntero
+struct HeapBlob {
+    long id = 0;
+    std::vector<char> bytes;
+};
+
+constexpr std::size_t BLOB_SIZE = 1024;
+
+long payload_id(int v) { return v; }
+long payload_id(const Payload64& p) { return p.id; }
+long payload_id(const HeapBlob& b) { return b.id; }
+long payload_id(const std::unique_ptr<Payload64>& p) { return p ? p->id : 0; }
+
+template <class T> T make_payload(long id);
+
+template <> int make_payload<int>(long id) { return static_cast<int>(id); }
+
+template <> Payload64 make_payload<Payload64>(long id) {
+    Payload64 p;
+    p.id = id;
+    std::memset(p.data, static_cast<int>(id & 0xff), sizeof(p.data));
+    return p;
+}
+
+template <> HeapBlob make_payload<HeapBlob>(long id) {
+    HeapBlob b;
+    b.id = id;
+    b.bytes.assign(BLOB_SIZE, static_cast<char>(id & 0xff));
+    return b;
+}
+
+template <> std::unique_ptr<Payload64> make_payload<std::unique_ptr<Payload64>>(long id) {
+    return std::make_unique<Payload64>(make_payload<Payload64>(id));
+}
+
+template <class T>
+struct PayloadArgs {
+    Ring<T>* ring;
+    int thread_id;
+    long iterations;
+    long checksum;     // Suma de ids consumidos (verificación)
+};
+
+template <class T, bool Move>
+void* payload_producer(void* arg) {
+    auto* args = static_cast<PayloadArgs<T>*>(arg);
+    for (long i = 0; i < args->iterations; i++) {
+        T item = make_payload<T>(static_cast<long>(args->thread_id) * ITEM_ID_STRIDE + i);
+        if constexpr (Move) {
+            ring_push(args->ring, std::move(item));
+        } else {
+            ring_push(args->ring, item);  // Copia: item sigue vivo en el productor
+        }
+    }
+    return nullptr;
+}
+
+template <class T>
+void* payload_consumer(void* arg) {
+    auto* args = static_cast<PayloadArgs<T>*>(arg);
+    T item{};
+    while (ring_pop(args->ring, &item)) {
+        args->checksum += payload_id(item);
+    }
+    return nullptr;
+}
+
+/**
+ * Throughput de Ring<T> para un tipo de carga, por copia o por movimiento
+ * Los consumidores verifican la suma de ids de todos los elementos
+ */
+template <class T, bool Move>
+void run_payload(const char* name, int producers, int consumers, long items_per_producer) {
+    printf("\n=== PAYLOAD: %s (%zu bytes, %s) ===\n",
+           name, sizeof(T), Move ? "movimiento" : "copia");
+    
+    Ring<T> ring;
+    std::vector<pthread_t> threads(producers + consumers);
+    std::vector<PayloadArgs<T>> args(producers + consumers);
+    
+    double start_time = now_s();
+    for (int i = 0; i < producers; i++) {
+        args[i] = {&ring, i, items_per_producer, 0};
+        pthread_create(&threads[i], nullptr, payload_producer<T, Move>, &args[i]);
+    }
+    for (int i = 0; i < consumers; i++) {
+        args[producers + i] = {&ring, i, 0, 0};
+        pthread_create(&threads[producers + i], nullptr, payload_consumer<T>, &args[producers + i]);
+    }
+    for (int i = 0; i < producers; i++) {
+        pthread_join(threads[i], nullptr);
+    }
+    // Productores terminaron: pop drena la cola antes de retornar false
+    ring_shutdown(&ring);
+    long checksum = 0;
+    for (int i = 0; i < consumers; i++) {
+        pthread_join(threads[producers + i], nullptr);
+        checksum += args[producers + i].checksum;
+    }
+    double total_time = now_s() - start_time;
+    
+    long expected = 0;
+    for (int p = 0; p < producers; p++) {
+        for (long i = 0; i < items_per_producer; i++) {
+            expected += static_cast<long>(p) * ITEM_ID_STRIDE + i;
+        }
+    }
+    
+    printf("Tiempo total: %.4f segundos\n", total_time);
+    printf("Elementos consumidos: %ld\n", ring.total_consumed);
+    printf("Throughput: %.0f elementos/segundo\n", ring.total_consumed / total_time);
+    printf("Corrección: %s\n", checksum == expected ? "CORRECTO" : "ERROR - checksum distinto");
+    ring_destroy(&ring);
+}
+
+void run_payload_suite(int producers, int consumers, long items_per_producer) {
+    run_payload<int, false>("int", producers, consumers, items_per_producer);
+    run_payload<Payload64, false>("POD 64 bytes", producers, consumers, items_per_producer);
+    run_payload<HeapBlob, false>("HeapBlob 1 KB", producers, consumers, items_per_producer);
+    run_payload<HeapBlob, true>("HeapBlob 1 KB", producers, consumers, items_per_producer);
+    run_payload<std::unique_ptr<Payload64>, true>("unique_ptr<POD 64>", producers, consumers,
+                                                  items_per_producer);
+}
+
+// ---------------------------------------------------------------------------
+// Modo burst: productores en ráfagas, memoria residente y throughput
+// ---------------------------------------------------------------------------
+
+constexpr int BURSTS = 8;               // Ráfagas por productor
+constexpr uint64_t CONSUME_WORK_NS = 500; // Trabajo simulado por elemento consumido
+
+// Memoria residente del proceso en KB (/proc/self/statm)
+long rss_kb() {
+    FILE* f = std::fopen("/proc/self/statm", "r");
+    if (!f) return 0;
+    long size = 0;
+    long resident = 0;
+    if (std::fscanf(f, "%ld %ld", &size, &resident) != 2) resident = 0;
+    std::fclose(f);
+    return resident * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+// Muestrea RSS cada milisegundo y guarda el máximo
+struct RssSampler {
+    std::atomic<bool> running{true};
+    long peak_kb = 0;
+};
+
+void* rss_sampler_thread(void* arg) {
+    auto* s = static_cast<RssSampler*>(arg);
+    while (s->running.load(std::memory_order_acquire)) {
+        long kb = rss_kb();
+        if (kb > s->peak_kb) s->peak_kb = kb;
+        usleep(1000);
+    }
+    return nullptr;
+}
+
+template <class Q>
+struct BurstArgs {
+    Q* ring;
+    int thread_id;
+    long iterations;
+    int gap_ms;
+    std::atomic<long>* consumed;   // Progreso visible para el hilo principal
+    uint64_t last_consume_ns;
+};
+
+template <class Q>
+void* burst_producer(void* arg) {
+    auto* args = static_cast<BurstArgs<Q>*>(arg);
+    long per_burst = (args->iterations + BURSTS - 1) / BURSTS;
+    long i = 0;
+    for (int b = 0; b < BURSTS && i < args->iterations; b++) {
+        for (long k = 0; k < per_burst && i < args->iterations; k++, i++) {
+            Payload64 p;
+            p.id = static_cast<long>(args->thread_id) * ITEM_ID_STRIDE + i;
+            p.data[0] = static_cast<char>(i);
+            ring_push(args->ring, p);
+        }
+        usleep(args->gap_ms * 1000);  // Pausa entre ráfagas
+    }
+    return nullptr;
+}
+
+template <class Q>
+void* burst_consumer(void* arg) {
+    auto* args = static_cast<BurstArgs<Q>*>(arg);
+    Payload64 p;
+    while (ring_pop(args->ring, &p)) {
+        // Consumir es más lento que producir: durante la ráfaga la cola crece
+        uint64_t until = now_ns() + CONSUME_WORK_NS;
+        while (now_ns() < until) cpu_relax();
+        args->consumed->fetch_add(1, std::memory_order_relaxed);
+        args->last_consume_ns = now_ns();
+    }
+    return nullptr;
+}
+
+/**
+ * Ráfagas de productores sobre una cola de Payload64
+ * Reporta throughput, bloqueos de productores y RSS base/pico/inactivo
+ */
+template <class Q>
+void run_burst(const char* name, Q* ring, int producers, int consumers,
+               long items_per_producer, const RunOptions& opts) {
+    printf("\n=== BURST: %s ===\n", name);
+    
+    // La pausa entre ráfagas es menor que la ventana: el pool se conserva
+    int gap_ms = std::max(1, static_cast<int>(opts.idle_ms / 4));
+    if (opts.idle_ms == 0) gap_ms = 50;
+    
+    long base_kb = rss_kb();
+    RssSampler sampler;
+    pthread_t sampler_thread;
+    pthread_create(&sampler_thread, nullptr, rss_sampler_thread, &sampler);
+    
+    std::vector<pthread_t> threads(producers + consumers);
+    std::vector<BurstArgs<Q>> args(producers + consumers);
+    std::vector<std::atomic<long>> consumed_by(consumers);
+    uint64_t start_ns = now_ns();
+    for (int i = 0; i < producers; i++) {
+        args[i] = {ring, i, items_per_producer, gap_ms, nullptr, 0};
+        pthread_create(&threads[i], nullptr, burst_producer<Q>, &args[i]);
+    }
+    for (int i = 0; i < consumers; i++) {
+        consumed_by[i].store(0);
+        args[producers + i] = {ring, i, 0, gap_ms, &consumed_by[i], 0};
+        pthread_create(&threads[producers + i], nullptr, burst_consumer<Q>, &args[producers + i]);
+    }
+    for (int i = 0; i < producers; i++) {
+        pthread_join(threads[i], nullptr);
+    }
+    
+    // Esperar a que se drene y dejar la cola inactiva antes de medir
+    long expected = items_per_producer * producers;
+    auto drained = [&consumed_by] {
+        long total = 0;
+        for (const auto& c : consumed_by) total += c.load(std::memory_order_relaxed);
+        return total;
+    };
+    while (drained() < expected) {
+        usleep(1000);
+    }
+    unsigned idle_wait_ms = std::max(50u, opts.idle_ms * 3);
+    usleep(idle_wait_ms * 1000);
+    long idle_kb = rss_kb();
+    
+    ring_shutdown(ring);
+    long consumed = 0;
+    uint64_t end_ns = start_ns;
+    for (int i = 0; i < consumers; i++) {
+        pthread_join(threads[producers + i], nullptr);
+        consumed += consumed_by[i].load();
+        end_ns = std::max(end_ns, args[producers + i].last_consume_ns);
+    }
+    sampler.running.store(false, std::memory_order_release);
+    pthread_join(sampler_thread, nullptr);
+    
+    double total_time = (end_ns - start_ns) * 1e-9;
+    RingStats st = ring_stats(ring);
+    printf("Ráfagas: %d por productor, pausa %d ms\n", BURSTS, gap_ms);
+    printf("Tiempo total: %.4f segundos\n", total_time);
+    if (total_time > 0) {
+        printf("Throughput: %.0f elementos/segundo\n", consumed / total_time);
+    }
+    printf("Productores esperaron (cola llena): %ld veces\n", st.wait_full);
+    print_wait_details(ring);
+    printf("RSS base: %ld KB, pico: %ld KB (+%ld), inactivo tras %u ms: %ld KB (+%ld)\n",
+           base_kb, sampler.peak_kb, sampler.peak_kb - base_kb,
+           idle_wait_ms, idle_kb, idle_kb - base_kb);
+    printf("Corrección: %s\n", consumed == expected ? "CORRECTO" : "ERROR - pérdida de datos");
+    ring_destroy(ring);
+}
+
+void run_burst_suite(int producers, int consumers, long items_per_producer,
+                     const RunOptions& opts) {
+    printf("Inactividad para liberar segmentos: %u ms\n", opts.idle_ms);
+    {
+        Ring<Payload64> ring;
+        run_burst("Ring acotado (1024)", &ring, producers, consumers,
+                  items_per_producer, opts);
+    }
+    {
+        SegmentedQueue<Payload64> ring(opts.idle_ms);
+        run_burst("SegmentedQueue no acotada", &ring, producers, consumers,
+                  items_per_producer, opts);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Modo ipc: productores en procesos hijos (fork), el padre consume
+// ---------------------------------------------------------------------------
+
+constexpr int PIPE_READ_ITEMS = 256;   // Elementos leídos del pipe por read()
+
+struct IpcResult {
+    long consumed = 0;
+    long checksum = 0;
+    uint64_t end_ns = 0;
+    LatencyHistogram latency;
+};
+
+// CLOCK_MONOTONIC es común a todos los procesos: la latencia vale entre ellos
+void ipc_record(IpcResult* res, const TimedItem& item) {
+    uint64_t now = now_ns();
+    res->latency.record(now - item.enqueue_ns);
+    res->checksum += item.value;
+    res->consumed++;
+    res->end_ns = now;
+}
+
+void print_ipc_result(const char* name, const IpcResult& res, uint64_t start_ns,
+                      int producers, long items_per_producer) {
+    long expected = 0;
+    for (int p = 0; p < producers; p++) {
+        for (long i = 0; i < items_per_producer; i++) {
+            expected += static_cast<long>(p) * ITEM_ID_STRIDE + i;
+        }
+    }
+    double total_time = (res.end_ns - start_ns) * 1e-9;
+    printf("Tiempo total: %.4f segundos\n", total_time);
+    printf("Elementos consumidos: %ld\n", res.consumed);
+    if (total_time > 0) {
+        printf("Throughput: %.0f elementos/segundo\n", res.consumed / total_time);
+    }
+    res.latency.print(name);
+    printf("Corrección: %s\n", res.consumed == producers * items_per_producer &&
+                                res.checksum == expected ? "CORRECTO" : "ERROR - checksum distinto");
+}
+
+// Productor de un proceso hijo o hilo: items con id * STRIDE + i
+template <class Push>
+void ipc_produce(int id, long items, Push push) {
+    for (long i = 0; i < items; i++) {
+        push(TimedItem{static_cast<int>(id * ITEM_ID_STRIDE + i), now_ns()});
+    }
+}
+
+struct IpcThreadArgs {
+    Ring<TimedItem>* ring;
+    int thread_id;
+    long iterations;
+};
+
+void* ipc_thread_producer(void* arg) {
+    auto* args = static_cast<IpcThreadArgs*>(arg);
+    ipc_produce(args->thread_id, args->iterations,
+                [args](const TimedItem& item) { ring_push(args->ring, item); });
+    return nullptr;
+}
+
+// Referencia: la misma cola con productores como hilos del mismo proceso
+void run_ipc_threads(int producers, long items_per_producer) {
+    printf("\n=== IPC: Ring en proceso (hilos) ===\n");
+    Ring<TimedItem> ring;
+    IpcResult res;
+    std::vector<pthread_t> threads(producers);
+    std::vector<IpcThreadArgs> args(producers);
+    
+    uint64_t start_ns = now_ns();
+    for (int i = 0; i < producers; i++) {
+        args[i] = {&ring, i, items_per_producer};
+        pthread_create(&threads[i], nullptr, ipc_thread_producer, &args[i]);
+    }
+    TimedItem item;
+    for (long k = 0; k < producers * items_per_producer && ring_pop(&ring, &item); k++) {
+        ipc_record(&res, item);
+    }
+    for (int i = 0; i < producers; i++) {
+        pthread_join(threads[i], nullptr);
+    }
+    print_ipc_result("LATENCIA Ring en proceso", res, start_ns, producers, items_per_producer);
     ring_destroy(&ring);
+}
+
+// Espera a todos los hijos; retorna false si alguno falló
+bool wait_children(const std::vector<pid_t>& pids) {
+    bool ok = true;
+    for (pid_t pid : pids) {
+        int status = 0;
+        if (waitpid(pid, &status, 0) < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+// Elementos que un hijo lleva insertados (región compartida, uno por línea)
+struct alignas(CACHE_LINE) ShmPushed {
+    long count;
+};
+
+/**
+ * Vigila a los productores de ShmRing mientras el padre consume.
+ * Si un hijo termina con error (no pudo adjuntarse, o murió a mitad) la
+ * parte que no llegó a insertar se descuenta de `expected`; la cola sigue
+ * abierta para los demás. Recién con todos los hijos recogidos se cierra,
+ * así un consumidor que esperaba elementos que ya no llegarán despierta y
+ * ring_pop retorna false al vaciarla (ningún push se descarta por stop).
+ */
+struct ShmWatchArgs {
+    ShmRing<TimedItem, QUEUE_SIZE>* ring;
+    const std::vector<pid_t>* pids;    // pids[i] produce con id producer_ids[i]
+    const std::vector<int>* producer_ids;
+    const ShmPushed* pushed;
+    long items_per_producer;
+    std::atomic<long>* expected;
+    int failed;
+    long lost;                          // Elementos que los hijos fallidos no insertaron
+};
+
+void* shm_watch_children(void* arg) {
+    auto* args = static_cast<ShmWatchArgs*>(arg);
+    std::size_t pending = args->pids->size();
+    while (pending > 0) {
+        int status = 0;
+        pid_t pid = waitpid(-1, &status, 0);
+        if (pid < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        auto it = std::find(args->pids->begin(), args->pids->end(), pid);
+        if (it == args->pids->end()) continue;
+        pending--;
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            int id = (*args->producer_ids)[it - args->pids->begin()];
+            long missing = args->items_per_producer -
+                           __atomic_load_n(&args->pushed[id].count, __ATOMIC_ACQUIRE);
+            args->failed++;
+            args->lost += missing;
+            args->expected->fetch_sub(missing);
+        }
+    }
+    ring_shutdown(args->ring);
+    return nullptr;
+}
+
+// ShmRing en memfd: cada hijo se adjunta con el descriptor heredado
+void run_ipc_shm(int producers, long items_per_producer) {
+    printf("\n=== IPC: ShmRing (memfd, mutex/cond compartidos) ===\n");
+    int fd = -1;
+    auto* ring = shm_ring_create<TimedItem, QUEUE_SIZE>("lab6_shm_ring", &fd);
+    if (!ring) return;
+    
+    // Contadores de elementos insertados por hijo, compartidos tras el fork
+    std::size_t pushed_bytes = static_cast<std::size_t>(producers) * sizeof(ShmPushed);
+    void* pushed_mem = mmap(nullptr, pushed_bytes, PROT_READ | PROT_WRITE,
+                            MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (pushed_mem == MAP_FAILED) {
+        perror("mmap");
+        shm_ring_destroy(ring, fd);
+        return;
+    }
+    auto* pushed = static_cast<ShmPushed*>(pushed_mem);
+    
+    IpcResult res;
+    std::vector<pid_t> pids;
+    std::vector<int> producer_ids;
+    int fork_failed = 0;
+    fflush(stdout);  // Que los hijos no hereden salida pendiente
+    uint64_t start_ns = now_ns();
+    for (int i = 0; i < producers; i++) {
+        pid_t pid = fork();
+        if (pid == 0) {
+            auto* mine = shm_ring_attach<TimedItem, QUEUE_SIZE>(fd);
+            if (!mine) _exit(1);
+            ShmPushed* counter = &pushed[i];
+            ipc_produce(i, items_per_producer, [mine, counter](const TimedItem& item) {
+                ring_push(mine, item);
+                __atomic_store_n(&counter->count, counter->count + 1, __ATOMIC_RELEASE);
+            });
+            shm_ring_detach(mine);
+            _exit(0);
+        }
+        if (pid < 0) {
+            perror("fork");
+            fork_failed++;
+            continue;
+        }
+        pids.push_back(pid);
+        producer_ids.push_back(i);
+    }
+    
+    // Un productor sin proceso no insertará nada: no esperar su parte
+    long total = static_cast<long>(producers) * items_per_producer;
+    std::atomic<long> expected{static_cast<long>(pids.size()) * items_per_producer};
+    ShmWatchArgs watch = {ring, &pids, &producer_ids, pushed, items_per_producer, &expected, 0, 0};
+    pthread_t watcher;
+    pthread_create(&watcher, nullptr, shm_watch_children, &watch);
+    TimedItem item;
+    while (res.consumed < expected.load() && ring_pop(ring, &item)) {
+        ipc_record(&res, item);
+    }
+    pthread_join(watcher, nullptr);
+    
+    printf("Productores esperaron (cola llena): %ld veces\n", ring->wait_full);
+    printf("Consumidor esperó (cola vacía): %ld veces\n", ring->wait_empty);
+    if (fork_failed > 0 || watch.failed > 0) {
+        printf("Productores fallidos: %d sin proceso (fork), %d terminaron con error; "
+               "no insertaron %ld de %ld elementos (consumidos %ld de %ld insertados)\n",
+               fork_failed, watch.failed,
+               static_cast<long>(fork_failed) * items_per_producer + watch.lost, total,
+               res.consumed, expected.load());
+    }
+    print_ipc_result("LATENCIA ShmRing entre procesos", res, start_ns,
+                     producers, items_per_producer);
+    munmap(pushed_mem, pushed_bytes);
+    shm_ring_destroy(ring, fd);
+}
+
+// Línea base: un pipe; cada write de un TimedItem (< PIPE_BUF) es atómico
+void run_ipc_pipe(int producers, long items_per_producer) {
+    printf("\n=== IPC: pipe ===\n");
+    int pfd[2];
+    if (pipe(pfd) != 0) {
+        perror("pipe");
+        return;
+    }
+    
+    IpcResult res;
+    std::vector<pid_t> pids;
+    fflush(stdout);
+    uint64_t start_ns = now_ns();
+    for (int i = 0; i < producers; i++) {
+        pid_t pid = fork();
+        if (pid == 0) {
+            close(pfd[0]);
+            bool ok = true;
+            ipc_produce(i, items_per_producer, [&ok, &pfd](const TimedItem& item) {
+                if (ok && write(pfd[1], &item, sizeof(item)) != sizeof(item)) ok = false;
+            });
+            _exit(ok ? 0 : 1);
+        }
+        if (pid > 0) pids.push_back(pid);
+    }
+    close(pfd[1]);  // EOF cuando todos los hijos terminen
+    
+    // Todos los write son de un elemento completo, así que cada read
+    // devuelve un múltiplo de sizeof(TimedItem)
+    TimedItem buf[PIPE_READ_ITEMS];
+    ssize_t n;
+    while ((n = read(pfd[0], buf, sizeof(buf))) > 0) {
+        for (ssize_t k = 0; k < n / static_cast<ssize_t>(sizeof(TimedItem)); k++) {
+            ipc_record(&res, buf[k]);
+        }
+    }
+    close(pfd[0]);
+    if (!wait_children(pids)) printf("Algún productor terminó con error\n");
+    print_ipc_result("LATENCIA pipe", res, start_ns, producers, items_per_producer);
+}
+
+void run_ipc_suite(int producers, int consumers, long items_per_producer) {
+    if (consumers != 1) {
+        printf("Modo ipc: un solo consumidor (el proceso padre); se ignora C=%d\n", consumers);
+    }
+    run_ipc_threads(producers, items_per_producer);
+    run_ipc_shm(producers, items_per_producer);
+    run_ipc_pipe(producers, items_per_producer);
+}
+
+// ---------------------------------------------------------------------------
+// Modo bytes: mensajes de largo variable escritos y leídos en el lugar
+// ---------------------------------------------------------------------------
+
+constexpr std::size_t BYTE_MESSAGE_SIZES[] = {16, 64, 256, 1024, 4096, 16384, 65536};
+constexpr std::size_t BYTE_BENCH_BYTES = 128 << 20;   // Tope de bytes por tamaño
+
+struct ByteArgs {
+    ByteRing<>* ring;
+    std::size_t size;
+    long messages;
+    long errors;      // Largo, orden o contenido inesperado (consumidor)
+};
+
+void* byte_producer(void* arg) {
+    auto* args = static_cast<ByteArgs*>(arg);
+    for (long i = 0; i < args->messages; i++) {
+        unsigned char* p = byte_ring_reserve(args->ring, args->size);
+        if (!p) break;
+        std::memset(p, static_cast<int>(i & 0xff), args->size);  // Escribir en el lugar
+        byte_ring_commit(args->ring);
+    }
+    return nullptr;
+}
+
+void* byte_consumer(void* arg) {
+    auto* args = static_cast<ByteArgs*>(arg);
+    ByteView view;
+    for (long i = 0; i < args->messages; i++) {
+        if (!byte_ring_peek(args->ring, &view)) break;
+        unsigned char pattern = static_cast<unsigned char>(i & 0xff);
+        if (view.len != args->size || view.seq != static_cast<uint32_t>(i) ||
+            view.data[0] != pattern || view.data[view.len - 1] != pattern) {
+            args->errors++;
+        }
+        byte_ring_release(args->ring);
+    }
+    return nullptr;
+}
+
+// Un productor y un consumidor por tamaño de mensaje; MB/s y mensajes/s
+void run_bytes_suite(long max_messages) {
+    printf("ByteRing: %zu KB, mensaje máximo %zu bytes\n",
+           BYTE_RING_SIZE / 1024, ByteRing<>::MAX_MESSAGE);
+    for (std::size_t size : BYTE_MESSAGE_SIZES) {
+        long messages = std::min<long>(max_messages,
+                                       static_cast<long>(BYTE_BENCH_BYTES / size));
+        auto ring = std::make_unique<ByteRing<>>();   // 1 MB: en el heap, no en la pila
+        ByteArgs producer_args = {ring.get(), size, messages, 0};
+        ByteArgs consumer_args = {ring.get(), size, messages, 0};
+        
+        pthread_t producer, consumer;
+        double start = now_s();
+        pthread_create(&producer, nullptr, byte_producer, &producer_args);
+        pthread_create(&consumer, nullptr, byte_consumer, &consumer_args);
+        pthread_join(producer, nullptr);
+        pthread_join(consumer, nullptr);
+        double total_time = now_s() - start;
+        
+        printf("\n=== MENSAJES DE %zu BYTES ===\n", size);
+        printf("Mensajes: %ld (%.1f MB) en %.4f segundos\n",
+               ring->messages, ring->bytes / 1e6, total_time);
+        printf("Throughput: %.0f elementos/segundo\n", ring->messages / total_time);
+        printf("Ancho de banda: %.1f MB/s\n", ring->bytes / 1e6 / total_time);
+        printf("Registros de relleno: %ld\n", ring->paddings);
+        printf("Productor esperó (sin espacio): %ld, consumidor esperó (vacía): %ld\n",
+               ring->wait_full, ring->wait_empty);
+        printf("Corrección: %s\n", consumer_args.errors == 0 && ring->messages == messages
+               ? "CORRECTO" : "ERROR - mensaje inesperado");
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Modo select: un consumidor atiende varias colas con ring_select
+// ---------------------------------------------------------------------------
+
+constexpr uint64_t SELECT_TIMEOUT_NS = 100000000;   // Plazo de cada ring_select (100 ms)
+
+struct SelectArgs {
+    Ring<TimedItem>* ring;
+    Ring<TimedItem>* const* rings;   // Todas las colas (consumidor con select)
+    RingSelector* selector;
+    int queues;
+    int thread_id;
+    long iterations;
+    IpcResult* result;
+    long selects;
+    long timeouts;
+};
+
+// Productor de una cola: al terminar la cierra
+void* select_producer(void* arg) {
+    auto* args = static_cast<SelectArgs*>(arg);
+    ipc_produce(args->thread_id, args->iterations,
+                [args](const TimedItem& item) { ring_push(args->ring, item); });
+    ring_shutdown(args->ring);
+    return nullptr;
+}
+
+// Un consumidor por cola, bloqueado en ring_pop
+void* select_queue_consumer(void* arg) {
+    auto* args = static_cast<SelectArgs*>(arg);
+    TimedItem item;
+    while (ring_pop(args->ring, &item)) {
+        ipc_record(args->result, item);
+    }
+    return nullptr;
+}
+
+// Un solo consumidor: espera en el selector y vacía la cola lista sin bloquear
+void* select_consumer(void* arg) {
+    auto* args = static_cast<SelectArgs*>(arg);
+    std::size_t n = static_cast<std::size_t>(args->queues);
+    TimedItem item;
+    for (;;) {
+        int i = ring_select(args->selector, args->rings, n, now_ns() + SELECT_TIMEOUT_NS);
+        args->selects++;
+        if (i == RING_SELECT_CLOSED) break;
+        if (i == RING_SELECT_TIMEOUT) {
+            args->timeouts++;
+            continue;
+        }
+        while (ring_try_pop(args->rings[i], &item) == RING_OK) {
+            ipc_record(args->result, item);
+        }
+    }
+    return nullptr;
+}
+
+void run_select(bool use_select, int queues, long items_per_producer) {
+    printf("\n=== SELECT: %s ===\n", use_select
+           ? "1 consumidor con ring_select" : "1 consumidor por cola");
+    
+    std::vector<std::unique_ptr<Ring<TimedItem>>> storage;
+    std::vector<Ring<TimedItem>*> rings;
+    RingSelector selector;
+    for (int i = 0; i < queues; i++) {
+        storage.emplace_back(new Ring<TimedItem>());
+        rings.push_back(storage.back().get());
+        if (use_select) rings.back()->selector = &selector;
+    }
+    
+    int consumers = use_select ? 1 : queues;
+    std::vector<IpcResult> results(consumers);
+    std::vector<SelectArgs> producer_args(queues);
+    std::vector<SelectArgs> consumer_args(consumers);
+    std::vector<pthread_t> producers(queues);
+    std::vector<pthread_t> consumer_threads(consumers);
+    
+    uint64_t start_ns = now_ns();
+    for (int i = 0; i < consumers; i++) {
+        if (use_select) {
+            consumer_args[i] = {nullptr, rings.data(), &selector, queues, i, 0, &results[i], 0, 0};
+            pthread_create(&consumer_threads[i], nullptr, select_consumer, &consumer_args[i]);
+        } else {
+            consumer_args[i] = {rings[i], nullptr, nullptr, 1, i, 0, &results[i], 0, 0};
+            pthread_create(&consumer_threads[i], nullptr, select_queue_consumer, &consumer_args[i]);
+        }
+    }
+    for (int i = 0; i < queues; i++) {
+        producer_args[i] = {rings[i], nullptr, nullptr, 1, i, items_per_producer, nullptr, 0, 0};
+        pthread_create(&producers[i], nullptr, select_producer, &producer_args[i]);
+    }
+    for (int i = 0; i < queues; i++) {
+        pthread_join(producers[i], nullptr);
+    }
+    for (int i = 0; i < consumers; i++) {
+        pthread_join(consumer_threads[i], nullptr);
+    }
+    
+    IpcResult merged;
+    for (const IpcResult& r : results) {
+        merged.consumed += r.consumed;
+        merged.checksum += r.checksum;
+        merged.end_ns = std::max(merged.end_ns, r.end_ns);
+        merged.latency.merge(r.latency);
+    }
+    long waits = 0;
+    for (Ring<TimedItem>* r : rings) waits += r->wait_empty;
+    
+    printf("Hilos: %d productores + %d consumidores\n", queues, consumers);
+    if (use_select) {
+        printf("Llamadas a ring_select: %ld (%ld vencieron el plazo)\n",
+               consumer_args[0].selects, consumer_args[0].timeouts);
+        printf("Syscalls futex del selector: %ld wake + %ld wait\n",
+               selector.ready.wake_syscalls(), selector.ready.wait_syscalls());
+    } else {
+        printf("Consumidores esperaron (cola vacía): %ld veces\n", waits);
+    }
+    print_ipc_result(use_select ? "LATENCIA ring_select" : "LATENCIA hilo por cola",
+                     merged, start_ns, queues, items_per_producer);
+    for (Ring<TimedItem>* r : rings) ring_destroy(r);
+}
+
+void run_select_suite(int queues, long items_per_producer) {
+    printf("Colas: %d (un productor por cola)\n", queues);
+    run_select(false, queues, items_per_producer);
+    run_select(true, queues, items_per_producer);
+}
+
+/**
+ * Instancia la cola del modo pedido con elementos T
+ * (int, o TimedItem cuando se mide latencia con -l)
+ */
+template <class T>
+int run_mode(const char* mode, int producers, int consumers, long items_per_producer,
+             const RunOptions& opts) {
+    if (std::strcmp(mode, "mutex") == 0) {
+        Ring<T> ring;
+        run_ring(&ring, producers, consumers, items_per_producer, opts);
+    } else if (std::strcmp(mode, "futex") == 0) {
+        FutexRing<T> ring;
+        run_ring(&ring, producers, consumers, items_per_producer, opts);
+    } else if (std::strcmp(mode, "spsc") == 0) {
+        if (producers != 1 || consumers != 1) {
+            fprintf(stderr, "Modo spsc requiere exactamente 1 productor y 1 consumidor\n");
+            return 1;
+        }
+        SpscRing<QUEUE_SIZE, T> ring;
+        run_ring(&ring, producers, consumers, items_per_producer, opts);
+    } else if (std::strcmp(mode, "mpmc") == 0) {
+        MpmcQueue<QUEUE_SIZE, T> ring;
+        run_ring(&ring, producers, consumers, items_per_producer, opts);
+    } else if (std::strcmp(mode, "unbounded") == 0) {
+        SegmentedQueue<T> ring(opts.idle_ms);
+        run_ring(&ring, producers, consumers, items_per_producer, opts);
+    } else if (std::strcmp(mode, "steal") == 0) {
+        StealQueue<STEAL_SHARD_SIZE, T> ring(opts.shards > 0 ? opts.shards : producers);
+        run_ring(&ring, producers, consumers, items_per_producer, opts);
+    } else {
+        fprintf(stderr, "Modo desconocido: %s (usar mutex|futex|spsc|mpmc|steal|unbounded|burst|ipc|bytes|select|payload)\n", mode);
+        return 2;
+    }
     return 0;
-}
\ No newline at end of file
+}
+
+void usage(const char* prog) {
+    fprintf(stderr, "Uso: %s [productores] [consumidores] [items] [modo] [-b lote] [-l] [-r tasa] [-q colas] [-i ms]\n", prog);
+    fprintf(stderr, "  modo: mutex|futex|spsc|mpmc|steal|unbounded|burst|ipc|bytes|select|payload (por defecto mutex)\n");
+    fprintf(stderr, "  -b lote: push_n/pop_n de hasta `lote` elementos\n");
+    fprintf(stderr, "  -l: marca cada item al encolar e imprime histograma de latencia\n");
+    fprintf(stderr, "  -r tasa: lazo abierto a `tasa` elementos/s en total (implica -l)\n");
+    fprintf(stderr, "  -q colas: colas del modo steal (por defecto una por productor)\n");
+    fprintf(stderr, "  -i ms: inactividad antes de devolver segmentos (unbounded/burst, 0 = sin pool)\n");
+}
+
+int main(int argc, char** argv) {
+    RunOptions opts;
+    int opt;
+    while ((opt = getopt(argc, argv, "b:lr:q:i:h")) != -1) {
+        switch (opt) {
+            case 'b':
+                opts.batch = std::max(1, std::atoi(optarg));
+                opts.batched = true;
+                break;
+            case 'l':
+                opts.latency = true;
+                break;
+            case 'r':
+                opts.rate = std::atof(optarg);
+                opts.latency = opts.rate > 0;
+                break;
+            case 'q':
+                opts.shards = std::max(1, std::atoi(optarg));
+                break;
+            case 'i':
+                opts.idle_ms = static_cast<unsigned>(std::max(0, std::atoi(optarg)));
+                break;
+            default:
+                usage(argv[0]);
+                return 1;
+        }
+    }
+    
+    // Argumentos posicionales (getopt los deja al final)
+    int npos = argc - optind;
+    char** pos = argv + optind;
+    int producers = (npos > 0) ? std::atoi(pos[0]) : 2;
+    int consumers = (npos > 1) ? std::atoi(pos[1]) : 2;
+    long items_per_producer = (npos > 2) ? std::atol(pos[2]) : 100000;
+    const char* mode = (npos > 3) ? pos[3] : "mutex";
+    opts.check_order = items_per_producer <= ITEM_ID_STRIDE;
+    if (opts.rate > 0 && opts.batched) {
+        fprintf(stderr, "-r no se combina con -b: el lazo abierto envía de a un elemento\n");
+        return 1;
+    }
+    
+    printf("Laboratorio 6 - Práctica 2: Buffer Circular\n");
+    printf("Configuración: %d productores, %d consumidores\n", producers, consumers);
+    printf("Items por productor: %ld (total: %ld)\n", 
+           items_per_producer, items_per_producer * producers);
+    printf("Modo: %s\n", mode);
+    if (opts.batched) {
+        printf("Lote: %d elementos por operación\n", opts.batch);
+    }
+    if (opts.rate > 0) {
+        printf("Lazo abierto: %.0f elementos/segundo en total\n", opts.rate);
+    }
+    
+    if (std::strcmp(mode, "payload") == 0) {
+        run_payload_suite(producers, consumers, items_per_producer);
+        return 0;
+    }
+    if (std::strcmp(mode, "select") == 0) {
+        run_select_suite(producers, items_per_producer);
+        return 0;
+    }
+    if (std::strcmp(mode, "bytes") == 0) {
+        run_bytes_suite(items_per_producer);
+        return 0;
+    }
+    if (std::strcmp(mode, "ipc") == 0) {
+        run_ipc_suite(producers, consumers, items_per_producer);
+        return 0;
+    }
+    if (std::strcmp(mode, "burst") == 0) {
+        run_burst_suite(producers, consumers, items_per_producer, opts);
+        return 0;
+    }
+    
+    int rc = opts.latency
+             ? run_mode<TimedItem>(mode, producers, consumers, items_per_producer, opts)
+             : run_mode<int>(mode, producers, consumers, items_per_producer, opts);
+    if (rc == 2) {
+        usage(argv[0]);
+        return 1;
+    }
+    return rc;
+}
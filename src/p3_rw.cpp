@@ -5,18 +5,58 @@
  * Autor: Denil Parada 24761
  * Compara pthread_rwlock_t vs pthread_mutex_t en una tabla hash compartida
  * Evalúa throughput bajo diferentes proporciones de lectura/escritura
+ *
+ * Variantes:
+ *   MUTEX    - un mutex para toda la tabla
+ *   RWLOCK   - un rwlock para toda la tabla
+ *   STRIPED  - un rwlock por franja de buckets (-s franjas)
+ *   FLAT     - direccionamiento abierto (sondeo lineal) con un rwlock
+ *   EPOCH    - lecturas sin candados; borrado con recuperación por épocas
+ *   SEQLOCK  - seqlock por bucket: lectores reintentan, actualizaciones sin candado global
+ *   RESIZE   - rwlock; duplica los buckets con migración incremental
+ *
+ * Sin borrados por defecto; con -d ese % de las escrituras son borrados.
+ * La recuperación por épocas se ejercita además en una corrida EPOCH con
+ * EPOCH_REMOVE_PCT% de borrados tras el barrido.
+ * Con -w se corren en su lugar mezclas YCSB (A/B/C/D) sobre MUTEX y RWLOCK
+ * con claves uniformes, zipf, recientes y hotspot (include/workload.hpp).
  */
 
 #include <pthread.h>
+#include <sched.h>
+#include <getopt.h>
+#include <malloc.h>
 #include <cstdio>
 #include <cstdlib>
 #include <vector>
 #include <cstdint>
 #include <unistd.h>
+#include <atomic>
+#include <new>
+#include "../include/cacheline.hpp"
+#include "../include/epoch.hpp"
+#include "../include/spin.hpp"
+#include "../include/workload.hpp"
+#include "../include/node_arena.hpp"
 #include "../include/timing.hpp"
+#include "../include/perf_counters.hpp"
 
 constexpr int NBUCKET = 1024;
 constexpr int MAX_CHAIN = 8;
+constexpr int DEFAULT_STRIPES = 64;
+constexpr int DEFAULT_REMOVE_PCT = 0;     // % de las escrituras que son borrados (-d)
+constexpr int EPOCH_REMOVE_PCT = 20;      // Borrados de la corrida EPOCH que ejercita la recuperación
+constexpr int KEY_RANGE = 10000;          // Claves 0..KEY_RANGE-1
+constexpr int FLAT_BITS = 14;
+constexpr int FLAT_CAPACITY = 1 << FLAT_BITS;  // ~61% de ocupación con KEY_RANGE claves
+constexpr int FLAT_EMPTY = -1;            // Las claves son no negativas
+constexpr int LOOKUP_OPS = 1 << 20;
+constexpr int ALLOC_KEY_RANGE = 1 << 16;  // Mayoría de inserciones en la comparación de asignadores
+constexpr int RESIZE_INITIAL_BITS = 10;   // 1024 buckets iniciales, como NBUCKET
+constexpr int RESIZE_MAX_LOAD = 2;        // Elementos por bucket que disparan la duplicación
+constexpr int RESIZE_STEP = 4;            // Buckets migrados por cada escritura
+constexpr int RESIZE_FIXED_MAX_KEYS = 1000000;  // Mayor espacio en que se corre la tabla fija
+constexpr double DEFAULT_ZIPF_THETA = 0.99;  // Valor por defecto de YCSB
 
 struct Node {
     int key;
@@ -26,6 +66,25 @@ struct Node {
     Node(int k, int v) : key(k), value(v), next(nullptr) {}
 };
 
+/**
+ * Libera las cadenas de una tabla encadenada: con arena basta soltar sus
+ * bloques; sin arena cada nodo se creó con new y se borra uno a uno.
+ */
+void free_chains(Node** buckets, bool pooled, NodeArena<Node>* arena) {
+    if (pooled) {
+        arena->release();
+        return;
+    }
+    for (int i = 0; i < NBUCKET; i++) {
+        Node* current = buckets[i];
+        while (current) {
+            Node* next = current->next;
+            delete current;
+            current = next;
+        }
+    }
+}
+
 struct HashMapMutex {
     Node* buckets[NBUCKET];
     pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
@@ -35,7 +94,11 @@ struct HashMapMutex {
     long writes = 0;
     long collisions = 0;
     
-    HashMapMutex() {
+    // Con pooled = true los nodos salen de la arena (inserciones con NodeCache)
+    bool pooled;
+    NodeArena<Node> arena;
+    
+    explicit HashMapMutex(bool use_arena = false) : pooled(use_arena) {
         for (int i = 0; i < NBUCKET; i++) {
             buckets[i] = nullptr;
         }
@@ -43,15 +106,7 @@ struct HashMapMutex {
     
     ~HashMapMutex() {
         pthread_mutex_destroy(&mutex);
-        // Cleanup chains
-        for (int i = 0; i < NBUCKET; i++) {
-            Node* current = buckets[i];
-            while (current) {
-                Node* next = current->next;
-                delete current;
-                current = next;
-            }
-        }
+        free_chains(buckets, pooled, &arena);
     }
 };
 
@@ -64,7 +119,11 @@ struct HashMapRWLock {
     long writes = 0;
     long collisions = 0;
     
-    HashMapRWLock() {
+    // Con pooled = true los nodos salen de la arena (inserciones con NodeCache)
+    bool pooled;
+    NodeArena<Node> arena;
+    
+    explicit HashMapRWLock(bool use_arena = false) : pooled(use_arena) {
         for (int i = 0; i < NBUCKET; i++) {
             buckets[i] = nullptr;
         }
@@ -72,16 +131,51 @@ struct HashMapRWLock {
     
     ~HashMapRWLock() {
         pthread_rwlock_destroy(&rwlock);
-        // Cleanup chains
+        free_chains(buckets, pooled, &arena);
+    }
+};
+
+/**
+ * Tabla hash con candados por franjas (lock striping).
+ * Los NBUCKET buckets se reparten en `stripes` franjas (bucket % stripes) y
+ * cada franja tiene su propio rwlock: escrituras a claves de franjas
+ * distintas ya no se serializan. Los contadores también son por franja, en
+ * la misma línea de caché que su candado; un contador global volvería a
+ * poner a todos los hilos a escribir la misma línea.
+ */
+struct HashMapStriped {
+    struct alignas(CACHE_LINE) Stripe {
+        pthread_rwlock_t rwlock = PTHREAD_RWLOCK_INITIALIZER;
+        long reads = 0;
+        long writes = 0;
+        long collisions = 0;
+    };
+    
+    Node* buckets[NBUCKET];
+    std::vector<Stripe> stripes;
+    bool pooled;
+    NodeArena<Node> arena;
+    
+    explicit HashMapStriped(int count, bool use_arena = false)
+        : stripes(count < 1 ? 1 : (count > NBUCKET ? NBUCKET : count)), pooled(use_arena) {
         for (int i = 0; i < NBUCKET; i++) {
-            Node* current = buckets[i];
-            while (current) {
-                Node* next = current->next;
-                delete current;
-                current = next;
-            }
+            buckets[i] = nullptr;
+        }
+    }
+    
+    ~HashMapStriped() {
+        for (auto& stripe : stripes) {
+            pthread_rwlock_destroy(&stripe.rwlock);
         }
+        free_chains(buckets, pooled, &arena);
     }
+    
+    Stripe& stripe_for(int bucket) { return stripes[bucket % stripes.size()]; }
+    
+    // Totales (sin hilos operando)
+    long reads() const { long n = 0; for (const auto& s : stripes) n += s.reads; return n; }
+    long writes() const { long n = 0; for (const auto& s : stripes) n += s.writes; return n; }
+    long collisions() const { long n = 0; for (const auto& s : stripes) n += s.collisions; return n; }
 };
 
 // Función hash simple
@@ -110,7 +204,9 @@ int map_get_mutex(HashMapMutex* map, int key) {
     return result;
 }
 
-void map_put_mutex(HashMapMutex* map, int key, int value) {
+void map_put_mutex(HashMapMutex* map, int key, int value, NodeCache<Node>* cache = nullptr) {
+    // Con caché el nodo se toma y construye antes de la sección crítica
+    Node* spare = cache ? new (cache->alloc()) Node(key, value) : nullptr;
     pthread_mutex_lock(&map->mutex);
     
     int bucket = hash_func(key);
@@ -122,13 +218,14 @@ void map_put_mutex(HashMapMutex* map, int key, int value) {
             current->value = value;  // Actualizar
             __sync_fetch_and_add(&map->writes, 1);
             pthread_mutex_unlock(&map->mutex);
+            if (spare) cache->free(spare);
             return;
         }
         current = current->next;
     }
     
     // Insertar nuevo nodo al inicio
-    Node* new_node = new Node(key, value);
+    Node* new_node = spare ? spare : new Node(key, value);
     new_node->next = map->buckets[bucket];
     if (map->buckets[bucket] != nullptr) {
         __sync_fetch_and_add(&map->collisions, 1);
@@ -160,7 +257,9 @@ int map_get_rwlock(HashMapRWLock* map, int key) {
     return result;
 }
 
-void map_put_rwlock(HashMapRWLock* map, int key, int value) {
+void map_put_rwlock(HashMapRWLock* map, int key, int value, NodeCache<Node>* cache = nullptr) {
+    // Con caché el nodo se toma y construye antes de la sección crítica
+    Node* spare = cache ? new (cache->alloc()) Node(key, value) : nullptr;
     pthread_rwlock_wrlock(&map->rwlock);
     
     int bucket = hash_func(key);
@@ -172,13 +271,14 @@ void map_put_rwlock(HashMapRWLock* map, int key, int value) {
             current->value = value;  // Actualizar
             __sync_fetch_and_add(&map->writes, 1);
             pthread_rwlock_unlock(&map->rwlock);
+            if (spare) cache->free(spare);
             return;
         }
         current = current->next;
     }
     
     // Insertar nuevo nodo al inicio
-    Node* new_node = new Node(key, value);
+    Node* new_node = spare ? spare : new Node(key, value);
     new_node->next = map->buckets[bucket];
     if (map->buckets[bucket] != nullptr) {
         __sync_fetch_and_add(&map->collisions, 1);
@@ -189,45 +289,900 @@ void map_put_rwlock(HashMapRWLock* map, int key, int value) {
     pthread_rwlock_unlock(&map->rwlock);
 }
 
+// Operaciones con candado por franja
+int map_get_striped(HashMapStriped* map, int key) {
+    int bucket = hash_func(key);
+    auto& stripe = map->stripe_for(bucket);
+    pthread_rwlock_rdlock(&stripe.rwlock);
+    
+    Node* current = map->buckets[bucket];
+    int result = -1;
+    
+    while (current) {
+        if (current->key == key) {
+            result = current->value;
+            break;
+        }
+        current = current->next;
+    }
+    
+    __sync_fetch_and_add(&stripe.reads, 1);
+    pthread_rwlock_unlock(&stripe.rwlock);
+    return result;
+}
+
+void map_put_striped(HashMapStriped* map, int key, int value, NodeCache<Node>* cache = nullptr) {
+    Node* spare = cache ? new (cache->alloc()) Node(key, value) : nullptr;
+    int bucket = hash_func(key);
+    auto& stripe = map->stripe_for(bucket);
+    pthread_rwlock_wrlock(&stripe.rwlock);
+    
+    Node* current = map->buckets[bucket];
+    
+    // Buscar si ya existe
+    while (current) {
+        if (current->key == key) {
+            current->value = value;  // Actualizar
+            stripe.writes++;
+            pthread_rwlock_unlock(&stripe.rwlock);
+            if (spare) cache->free(spare);
+            return;
+        }
+        current = current->next;
+    }
+    
+    // Insertar nuevo nodo al inicio
+    Node* new_node = spare ? spare : new Node(key, value);
+    new_node->next = map->buckets[bucket];
+    if (map->buckets[bucket] != nullptr) {
+        stripe.collisions++;
+    }
+    map->buckets[bucket] = new_node;
+    
+    stripe.writes++;
+    pthread_rwlock_unlock(&stripe.rwlock);
+}
+
+// Desenlaza la clave de una cadena; retorna el nodo o nullptr si no estaba
+Node* unlink_node(Node** head, int key) {
+    for (Node** link = head; *link; link = &(*link)->next) {
+        if ((*link)->key == key) {
+            Node* found = *link;
+            *link = found->next;
+            return found;
+        }
+    }
+    return nullptr;
+}
+
+// Devuelve un nodo borrado: a la caché del hilo si la tabla usa arena
+void drop_node(Node* node, NodeCache<Node>* cache) {
+    if (cache) {
+        cache->free(node);
+    } else {
+        delete node;
+    }
+}
+
+// Borrados en tablas encadenadas; el nodo se libera fuera de la sección crítica
+bool map_remove_mutex(HashMapMutex* map, int key, NodeCache<Node>* cache = nullptr) {
+    pthread_mutex_lock(&map->mutex);
+    Node* found = unlink_node(&map->buckets[hash_func(key)], key);
+    __sync_fetch_and_add(&map->writes, 1);
+    pthread_mutex_unlock(&map->mutex);
+    if (found) drop_node(found, cache);
+    return found != nullptr;
+}
+
+bool map_remove_rwlock(HashMapRWLock* map, int key, NodeCache<Node>* cache = nullptr) {
+    pthread_rwlock_wrlock(&map->rwlock);
+    Node* found = unlink_node(&map->buckets[hash_func(key)], key);
+    __sync_fetch_and_add(&map->writes, 1);
+    pthread_rwlock_unlock(&map->rwlock);
+    if (found) drop_node(found, cache);
+    return found != nullptr;
+}
+
+bool map_remove_striped(HashMapStriped* map, int key, NodeCache<Node>* cache = nullptr) {
+    int bucket = hash_func(key);
+    auto& stripe = map->stripe_for(bucket);
+    pthread_rwlock_wrlock(&stripe.rwlock);
+    Node* found = unlink_node(&map->buckets[bucket], key);
+    stripe.writes++;
+    pthread_rwlock_unlock(&stripe.rwlock);
+    if (found) drop_node(found, cache);
+    return found != nullptr;
+}
+
+/**
+ * Tabla hash de direccionamiento abierto con sondeo lineal.
+ * Claves y valores viven en dos arreglos contiguos: una búsqueda recorre
+ * posiciones consecutivas de `keys` (16 claves por línea de caché) y solo
+ * toca `values` al encontrar la clave, en lugar de saltar de nodo en nodo.
+ * No hay reservas de memoria por inserción.
+ *
+ * El borrado no deja lápidas: desplaza hacia atrás los elementos siguientes
+ * del mismo grupo (backward shift), así las búsquedas nunca recorren
+ * posiciones muertas. Capacidad fija; put rechaza claves nuevas por encima
+ * de 7/8 de ocupación para que los sondeos sigan siendo cortos.
+ */
+struct HashMapFlat {
+    static constexpr int MASK = FLAT_CAPACITY - 1;
+    static constexpr int MAX_SIZE = FLAT_CAPACITY / 8 * 7;
+    
+    int keys[FLAT_CAPACITY];
+    int values[FLAT_CAPACITY];
+    int size = 0;
+    pthread_rwlock_t rwlock = PTHREAD_RWLOCK_INITIALIZER;
+    
+    // Estadísticas
+    long reads = 0;
+    long writes = 0;
+    long collisions = 0;   // Inserciones fuera de su posición casa
+    long rejected = 0;     // Inserciones rechazadas por ocupación
+    
+    HashMapFlat() {
+        for (int i = 0; i < FLAT_CAPACITY; i++) {
+            keys[i] = FLAT_EMPTY;
+        }
+    }
+    
+    ~HashMapFlat() {
+        pthread_rwlock_destroy(&rwlock);
+    }
+    
+    // Hash de Fibonacci: los FLAT_BITS bits altos del producto
+    static int home(int key) {
+        return static_cast<int>((key * 2654435761U) >> (32 - FLAT_BITS));
+    }
+    
+    // Posición de la clave o de la primera vacía de su grupo
+    int find_slot(int key) const {
+        int i = home(key);
+        while (keys[i] != key && keys[i] != FLAT_EMPTY) {
+            i = (i + 1) & MASK;
+        }
+        return i;
+    }
+};
+
+// Operaciones con direccionamiento abierto
+int map_get_flat(HashMapFlat* map, int key) {
+    pthread_rwlock_rdlock(&map->rwlock);
+    
+    int slot = map->find_slot(key);
+    int result = (map->keys[slot] == key) ? map->values[slot] : -1;
+    
+    __sync_fetch_and_add(&map->reads, 1);
+    pthread_rwlock_unlock(&map->rwlock);
+    return result;
+}
+
+void map_put_flat(HashMapFlat* map, int key, int value) {
+    pthread_rwlock_wrlock(&map->rwlock);
+    
+    int slot = map->find_slot(key);
+    if (map->keys[slot] == key) {
+        map->values[slot] = value;  // Actualizar
+    } else if (map->size < HashMapFlat::MAX_SIZE) {
+        map->keys[slot] = key;
+        map->values[slot] = value;
+        map->size++;
+        if (slot != HashMapFlat::home(key)) {
+            map->collisions++;
+        }
+    } else {
+        map->rejected++;
+    }
+    
+    map->writes++;
+    pthread_rwlock_unlock(&map->rwlock);
+}
+
+// Borra la clave; retorna false si no estaba
+bool map_remove_flat(HashMapFlat* map, int key) {
+    pthread_rwlock_wrlock(&map->rwlock);
+    
+    int hole = map->find_slot(key);
+    if (map->keys[hole] != key) {
+        pthread_rwlock_unlock(&map->rwlock);
+        return false;
+    }
+    
+    // Desplazamiento hacia atrás: un elemento puede ocupar el hueco si el
+    // hueco está entre su posición casa y su posición actual (cíclicamente)
+    constexpr int MASK = HashMapFlat::MASK;
+    for (int j = (hole + 1) & MASK; map->keys[j] != FLAT_EMPTY; j = (j + 1) & MASK) {
+        int h = HashMapFlat::home(map->keys[j]);
+        if (((j - h) & MASK) >= ((j - hole) & MASK)) {
+            map->keys[hole] = map->keys[j];
+            map->values[hole] = map->values[j];
+            hole = j;
+        }
+    }
+    map->keys[hole] = FLAT_EMPTY;
+    map->size--;
+    
+    map->writes++;
+    pthread_rwlock_unlock(&map->rwlock);
+    return true;
+}
+
+struct EpochNode {
+    int key;
+    std::atomic<int> value;
+    std::atomic<EpochNode*> next;
+    
+    EpochNode(int k, int v) : key(k), value(v), next(nullptr) {}
+};
+
+/**
+ * Tabla encadenada con lecturas sin candados (estilo RCU).
+ * Los lectores recorren las cadenas con cargas acquire dentro de una
+ * sección de época: no toman candados ni escriben memoria compartida
+ * (el anuncio de época y el contador de lecturas son por hilo).
+ * Los escritores se serializan por franja con un mutex; publican nodos
+ * nuevos con una store release sobre la cabeza del bucket y actualizan
+ * valores en el lugar. Un nodo borrado se desenlaza y se retira al
+ * EpochDomain, que lo libera cuando ya ningún lector puede estar en él.
+ */
+struct HashMapEpoch {
+    struct alignas(CACHE_LINE) WriterStripe {
+        pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+        long writes = 0;
+        long collisions = 0;
+    };
+    
+    struct alignas(CACHE_LINE) ReaderCount {
+        long reads = 0;
+    };
+    
+    std::atomic<EpochNode*> buckets[NBUCKET];
+    std::vector<WriterStripe> stripes;
+    std::vector<ReaderCount> readers;   // Uno por hilo (índice del registro de época)
+    EpochDomain epoch;
+    
+    HashMapEpoch(int threads, int stripe_count)
+        : stripes(stripe_count < 1 ? 1 : (stripe_count > NBUCKET ? NBUCKET : stripe_count)),
+          readers(threads < 1 ? 1 : threads), epoch(threads < 1 ? 1 : threads) {
+        for (int i = 0; i < NBUCKET; i++) {
+            buckets[i].store(nullptr, std::memory_order_relaxed);
+        }
+    }
+    
+    ~HashMapEpoch() {
+        for (auto& stripe : stripes) {
+            pthread_mutex_destroy(&stripe.mutex);
+        }
+        for (int i = 0; i < NBUCKET; i++) {
+            EpochNode* current = buckets[i].load(std::memory_order_relaxed);
+            while (current) {
+                EpochNode* next = current->next.load(std::memory_order_relaxed);
+                delete current;
+                current = next;
+            }
+        }
+    }
+    
+    WriterStripe& stripe_for(int bucket) { return stripes[bucket % stripes.size()]; }
+    
+    long reads() const { long n = 0; for (const auto& r : readers) n += r.reads; return n; }
+    long writes() const { long n = 0; for (const auto& s : stripes) n += s.writes; return n; }
+    long collisions() const { long n = 0; for (const auto& s : stripes) n += s.collisions; return n; }
+};
+
+// Operaciones con lecturas por épocas (cada hilo llama antes a epoch_attach)
+int map_get_epoch(HashMapEpoch* map, int key) {
+    epoch_enter(&map->epoch);
+    
+    EpochNode* current = map->buckets[hash_func(key)].load(std::memory_order_acquire);
+    int result = -1;
+    
+    while (current) {
+        if (current->key == key) {
+            result = current->value.load(std::memory_order_relaxed);
+            break;
+        }
+        current = current->next.load(std::memory_order_acquire);
+    }
+    
+    epoch_exit(&map->epoch);
+    map->readers[EpochDomain::slot].reads++;
+    return result;
+}
+
+void map_put_epoch(HashMapEpoch* map, int key, int value) {
+    int bucket = hash_func(key);
+    auto& stripe = map->stripe_for(bucket);
+    pthread_mutex_lock(&stripe.mutex);
+    
+    EpochNode* head = map->buckets[bucket].load(std::memory_order_relaxed);
+    for (EpochNode* current = head; current; current = current->next.load(std::memory_order_relaxed)) {
+        if (current->key == key) {
+            current->value.store(value, std::memory_order_relaxed);  // Actualizar
+            stripe.writes++;
+            pthread_mutex_unlock(&stripe.mutex);
+            return;
+        }
+    }
+    
+    // Publicar el nodo completo: los lectores lo ven recién con la store release
+    auto* new_node = new EpochNode(key, value);
+    new_node->next.store(head, std::memory_order_relaxed);
+    if (head != nullptr) {
+        stripe.collisions++;
+    }
+    map->buckets[bucket].store(new_node, std::memory_order_release);
+    
+    stripe.writes++;
+    pthread_mutex_unlock(&stripe.mutex);
+}
+
+bool map_remove_epoch(HashMapEpoch* map, int key) {
+    int bucket = hash_func(key);
+    auto& stripe = map->stripe_for(bucket);
+    pthread_mutex_lock(&stripe.mutex);
+    
+    // El nodo desenlazado conserva su next: un lector que esté en él sigue de largo
+    EpochNode* found = nullptr;
+    std::atomic<EpochNode*>* link = &map->buckets[bucket];
+    for (EpochNode* current = link->load(std::memory_order_relaxed); current;
+         current = link->load(std::memory_order_relaxed)) {
+        if (current->key == key) {
+            link->store(current->next.load(std::memory_order_relaxed), std::memory_order_release);
+            found = current;
+            break;
+        }
+        link = &current->next;
+    }
+    
+    stripe.writes++;
+    pthread_mutex_unlock(&stripe.mutex);
+    if (found) epoch_retire(&map->epoch, found);
+    return found != nullptr;
+}
+
+struct SeqNode {
+    std::atomic<int> key;
+    std::atomic<int> value;
+    std::atomic<SeqNode*> next;
+    
+    SeqNode(int k, int v) : key(k), value(v), next(nullptr) {}
+};
+
+/**
+ * Tabla encadenada con un seqlock por bucket.
+ * Lectura: leer la secuencia (par), recorrer la cadena y volver a leerla;
+ * si cambió o era impar se reintenta. Los lectores no escriben memoria
+ * compartida (sus contadores son por hilo).
+ * Actualizar el valor de una clave existente solo toma el seqlock de su
+ * bucket (secuencia impar mientras escribe): no hay candado global.
+ * Insertar y borrar cambian la estructura: toman el mutex de escritura y
+ * además el seqlock del bucket para que sus lectores reintenten.
+ *
+ * Un lector puede estar sobre un nodo recién borrado, así que los nodos no
+ * se liberan: vuelven a una lista libre de la tabla y las inserciones los
+ * reutilizan (memoria de tipo estable). Un lector que siguió un nodo
+ * reciclado a otra cadena lo detecta porque la secuencia de su bucket cambió.
+ */
+struct HashMapSeqlock {
+    static constexpr int MAX_STEPS = 1 << 20;   // Tope de recorrido de un lector antes de revalidar
+    
+    struct Bucket {
+        std::atomic<unsigned> seq{0};
+        std::atomic<SeqNode*> head{nullptr};
+    };
+    
+    struct alignas(CACHE_LINE) ThreadStats {
+        long reads = 0;
+        long retries = 0;       // Lecturas repetidas por cambio de secuencia
+        long writes = 0;
+        long in_place = 0;      // Escrituras resueltas solo con el seqlock
+        long collisions = 0;
+    };
+    
+    static inline thread_local std::size_t slot = 0;
+    
+    Bucket buckets[NBUCKET];
+    pthread_mutex_t writer = PTHREAD_MUTEX_INITIALIZER;   // Cambios de estructura
+    SeqNode* free_nodes = nullptr;                         // Protegida por writer
+    std::vector<ThreadStats> stats;
+    
+    explicit HashMapSeqlock(int threads) : stats(threads < 1 ? 1 : threads) {}
+    
+    ~HashMapSeqlock() {
+        pthread_mutex_destroy(&writer);
+        for (int i = 0; i < NBUCKET; i++) {
+            free_chain(buckets[i].head.load(std::memory_order_relaxed));
+        }
+        free_chain(free_nodes);
+    }
+    
+    static void free_chain(SeqNode* current) {
+        while (current) {
+            SeqNode* next = current->next.load(std::memory_order_relaxed);
+            delete current;
+            current = next;
+        }
+    }
+    
+    ThreadStats& local() { return stats[slot]; }
+    
+    // Secuencia impar: los lectores del bucket reintentan hasta write_unlock.
+    // Mientras tanto los datos se escriben con stores release: un lector que
+    // vea un dato nuevo (carga acquire) verá también la secuencia impar o una
+    // posterior al releerla, sin necesidad de barreras explícitas
+    static unsigned write_lock(Bucket& b) {
+        for (int i = 0;; i++) {
+            unsigned s = b.seq.load(std::memory_order_relaxed);
+            if ((s & 1) == 0 &&
+                b.seq.compare_exchange_weak(s, s + 1, std::memory_order_acquire)) {
+                return s + 1;
+            }
+            cpu_relax();
+            if (i % 32 == 31) sched_yield();
+        }
+    }
+    
+    static void write_unlock(Bucket& b, unsigned odd) {
+        b.seq.store(odd + 1, std::memory_order_release);
+    }
+    
+    long total(long ThreadStats::*field) const {
+        long n = 0;
+        for (const auto& t : stats) n += t.*field;
+        return n;
+    }
+};
+
+void map_attach_seqlock(HashMapSeqlock* map, int id) {
+    HashMapSeqlock::slot = static_cast<std::size_t>(id) % map->stats.size();
+}
+
+// Operaciones con seqlock por bucket (cada hilo llama antes a map_attach_seqlock)
+int map_get_seqlock(HashMapSeqlock* map, int key) {
+    auto& b = map->buckets[hash_func(key)];
+    auto& st = map->local();
+    
+    for (int attempt = 0;; attempt++) {
+        unsigned s = b.seq.load(std::memory_order_acquire);
+        if (s & 1) {
+            // Escritor en curso: esperar sin tocar la línea
+            st.retries++;
+            cpu_relax();
+            if (attempt % 32 == 31) sched_yield();
+            continue;
+        }
+        
+        int result = -1;
+        int steps = 0;
+        for (SeqNode* current = b.head.load(std::memory_order_acquire);
+             current && steps < HashMapSeqlock::MAX_STEPS;
+             current = current->next.load(std::memory_order_acquire), steps++) {
+            if (current->key.load(std::memory_order_acquire) == key) {
+                result = current->value.load(std::memory_order_acquire);
+                break;
+            }
+        }
+        
+        // Las cargas acquire anteriores impiden adelantar esta relectura
+        if (b.seq.load(std::memory_order_relaxed) == s) {
+            st.reads++;
+            return result;
+        }
+        st.retries++;
+    }
+}
+
+// Busca la clave con el seqlock del bucket tomado
+SeqNode* seqlock_find(HashMapSeqlock::Bucket& b, int key) {
+    for (SeqNode* current = b.head.load(std::memory_order_relaxed); current;
+         current = current->next.load(std::memory_order_relaxed)) {
+        if (current->key.load(std::memory_order_relaxed) == key) return current;
+    }
+    return nullptr;
+}
+
+/**
+ * Búsqueda optimista, como la de un lector: no cambia la secuencia
+ * Retorna false si un escritor intervino; si no, *seq es la secuencia
+ * (par) con que se validó y *found el nodo o nullptr
+ */
+bool seqlock_try_find(HashMapSeqlock::Bucket& b, int key, unsigned* seq, SeqNode** found) {
+    unsigned s = b.seq.load(std::memory_order_acquire);
+    if (s & 1) return false;
+    SeqNode* result = nullptr;
+    int steps = 0;
+    for (SeqNode* current = b.head.load(std::memory_order_acquire);
+         current && steps < HashMapSeqlock::MAX_STEPS;
+         current = current->next.load(std::memory_order_acquire), steps++) {
+        if (current->key.load(std::memory_order_acquire) == key) {
+            result = current;
+            break;
+        }
+    }
+    if (b.seq.load(std::memory_order_relaxed) != s) return false;
+    *seq = s;
+    *found = result;
+    return true;
+}
+
+void map_put_seqlock(HashMapSeqlock* map, int key, int value) {
+    auto& b = map->buckets[hash_func(key)];
+    auto& st = map->local();
+    st.writes++;
+    
+    // Camino rápido: la clave existe, actualizar en el lugar. Se busca sin
+    // tomar el seqlock, así una clave ausente va directo a la inserción sin
+    // subir la secuencia (los lectores no reintentan por una búsqueda fallida)
+    unsigned seq;
+    SeqNode* candidate;
+    bool validated = seqlock_try_find(b, key, &seq, &candidate);
+    if (!validated || candidate) {
+        unsigned odd = HashMapSeqlock::write_lock(b);
+        // Si nadie escribió desde la validación el nodo sigue siendo el de la
+        // clave; si no (o la búsqueda no validó), buscar de nuevo con el seqlock
+        SeqNode* found = validated && odd == seq + 1 ? candidate : seqlock_find(b, key);
+        if (found) {
+            found->value.store(value, std::memory_order_release);
+            HashMapSeqlock::write_unlock(b, odd);
+            st.in_place++;
+            return;
+        }
+        HashMapSeqlock::write_unlock(b, odd);
+    }
+    
+    // Inserción: mutex de escritura y luego seqlock (siempre en ese orden)
+    pthread_mutex_lock(&map->writer);
+    unsigned odd = HashMapSeqlock::write_lock(b);
+    if (SeqNode* found = seqlock_find(b, key)) {
+        // Otro hilo la insertó entre ambos candados
+        found->value.store(value, std::memory_order_release);
+    } else {
+        SeqNode* node = map->free_nodes;
+        if (node) {
+            map->free_nodes = node->next.load(std::memory_order_relaxed);
+            node->key.store(key, std::memory_order_release);
+            node->value.store(value, std::memory_order_release);
+        } else {
+            node = new SeqNode(key, value);
+        }
+        SeqNode* head = b.head.load(std::memory_order_relaxed);
+        node->next.store(head, std::memory_order_release);
+        if (head != nullptr) {
+            st.collisions++;
+        }
+        b.head.store(node, std::memory_order_release);
+    }
+    HashMapSeqlock::write_unlock(b, odd);
+    pthread_mutex_unlock(&map->writer);
+}
+
+bool map_remove_seqlock(HashMapSeqlock* map, int key) {
+    auto& b = map->buckets[hash_func(key)];
+    map->local().writes++;
+    
+    pthread_mutex_lock(&map->writer);
+    unsigned odd = HashMapSeqlock::write_lock(b);
+    
+    SeqNode* found = nullptr;
+    std::atomic<SeqNode*>* link = &b.head;
+    for (SeqNode* current = link->load(std::memory_order_relaxed); current;
+         current = link->load(std::memory_order_relaxed)) {
+        if (current->key.load(std::memory_order_relaxed) == key) {
+            link->store(current->next.load(std::memory_order_relaxed), std::memory_order_release);
+            found = current;
+            break;
+        }
+        link = &current->next;
+    }
+    HashMapSeqlock::write_unlock(b, odd);
+    
+    // A la lista libre; el next del nodo se reescribe recién al reutilizarlo
+    // o acá, cuando la secuencia del bucket ya cambió
+    if (found) {
+        found->next.store(map->free_nodes, std::memory_order_release);
+        map->free_nodes = found;
+    }
+    pthread_mutex_unlock(&map->writer);
+    return found != nullptr;
+}
+
+/**
+ * Tabla encadenada que crece: al superar RESIZE_MAX_LOAD elementos por
+ * bucket reserva una tabla del doble y migra RESIZE_STEP buckets viejos en
+ * cada escritura siguiente, así ninguna operación paga el rehash completo.
+ * Mientras dura la migración conviven ambas tablas: un bucket viejo con
+ * índice < migrate_pos ya se movió y su clave se busca en la nueva.
+ *
+ * El índice son los `bits` altos del hash de Fibonacci, por lo que el
+ * bucket viejo i se reparte solo entre los nuevos 2i y 2i+1. La tabla nueva
+ * se reserva sin inicializar y esos dos buckets se ponen en cero justo
+ * antes de migrar el i: ni siquiera limpiar el arreglo del doble es O(n)
+ * dentro de una sola escritura.
+ * Un rwlock protege todo; las lecturas no migran.
+ */
+struct HashMapResizable {
+    struct Table {
+        Node** buckets = nullptr;
+        int bits = 0;
+        
+        std::size_t size() const { return std::size_t(1) << bits; }
+    };
+    
+    Table cur;                     // Destino de la migración (o única tabla)
+    Table old;                     // En migración; buckets == nullptr si no hay
+    std::size_t migrate_pos = 0;   // Buckets de `old` ya migrados
+    long count = 0;
+    pthread_rwlock_t rwlock = PTHREAD_RWLOCK_INITIALIZER;
+    
+    // Estadísticas
+    long reads = 0;
+    long writes = 0;
+    long collisions = 0;
+    long resizes = 0;
+    long migrated = 0;             // Buckets movidos en total
+    
+    HashMapResizable() { cur = make_table(RESIZE_INITIAL_BITS); }
+    
+    ~HashMapResizable() {
+        pthread_rwlock_destroy(&rwlock);
+        while (old.buckets) migrate_step();   // `cur` solo es válida hasta 2*migrate_pos
+        free_table(cur);
+        free_table(old);
+    }
+    
+    // zeroed = false: buckets sin inicializar, los limpia migrate_step
+    static Table make_table(int bits, bool zeroed = true) {
+        Table t;
+        t.bits = bits;
+        t.buckets = zeroed ? new Node*[t.size()]() : new Node*[t.size()];
+        return t;
+    }
+    
+    static void free_table(Table& t) {
+        if (!t.buckets) return;
+        for (std::size_t i = 0; i < t.size(); i++) {
+            Node* current = t.buckets[i];
+            while (current) {
+                Node* next = current->next;
+                delete current;
+                current = next;
+            }
+        }
+        delete[] t.buckets;
+        t.buckets = nullptr;
+    }
+    
+    static std::size_t index(int key, int bits) {
+        return (key * 2654435761U) >> (32 - bits);
+    }
+    
+    // Cadena donde vive (o viviría) la clave
+    Node** chain_for(int key) {
+        if (old.buckets) {
+            std::size_t i = index(key, old.bits);
+            if (i >= migrate_pos) return &old.buckets[i];
+        }
+        return &cur.buckets[index(key, cur.bits)];
+    }
+    
+    // Las funciones siguientes requieren el candado de escritura
+    
+    void migrate_step() {
+        if (!old.buckets) return;
+        for (int k = 0; k < RESIZE_STEP && migrate_pos < old.size(); k++, migrate_pos++) {
+            cur.buckets[2 * migrate_pos] = nullptr;
+            cur.buckets[2 * migrate_pos + 1] = nullptr;
+            Node* current = old.buckets[migrate_pos];
+            while (current) {
+                Node* next = current->next;
+                Node** dest = &cur.buckets[index(current->key, cur.bits)];
+                current->next = *dest;
+                *dest = current;
+                current = next;
+            }
+            old.buckets[migrate_pos] = nullptr;
+            migrated++;
+        }
+        if (migrate_pos == old.size()) {
+            delete[] old.buckets;
+            old.buckets = nullptr;
+        }
+    }
+    
+    void maybe_grow() {
+        if (old.buckets || count <= static_cast<long>(cur.size()) * RESIZE_MAX_LOAD) return;
+        old = cur;
+        cur = make_table(old.bits + 1, false);
+        migrate_pos = 0;
+        resizes++;
+    }
+};
+
+// Operaciones con tabla redimensionable
+int map_get_resizable(HashMapResizable* map, int key) {
+    pthread_rwlock_rdlock(&map->rwlock);
+    
+    Node* current = *map->chain_for(key);
+    int result = -1;
+    
+    while (current) {
+        if (current->key == key) {
+            result = current->value;
+            break;
+        }
+        current = current->next;
+    }
+    
+    __sync_fetch_and_add(&map->reads, 1);
+    pthread_rwlock_unlock(&map->rwlock);
+    return result;
+}
+
+void map_put_resizable(HashMapResizable* map, int key, int value) {
+    pthread_rwlock_wrlock(&map->rwlock);
+    map->migrate_step();
+    
+    Node** chain = map->chain_for(key);
+    for (Node* current = *chain; current; current = current->next) {
+        if (current->key == key) {
+            current->value = value;  // Actualizar
+            map->writes++;
+            pthread_rwlock_unlock(&map->rwlock);
+            return;
+        }
+    }
+    
+    Node* new_node = new Node(key, value);
+    new_node->next = *chain;
+    if (*chain != nullptr) {
+        map->collisions++;
+    }
+    *chain = new_node;
+    map->count++;
+    map->maybe_grow();
+    
+    map->writes++;
+    pthread_rwlock_unlock(&map->rwlock);
+}
+
+bool map_remove_resizable(HashMapResizable* map, int key) {
+    pthread_rwlock_wrlock(&map->rwlock);
+    map->migrate_step();
+    Node* found = unlink_node(map->chain_for(key), key);
+    if (found) map->count--;
+    map->writes++;
+    pthread_rwlock_unlock(&map->rwlock);
+    delete found;
+    return found != nullptr;
+}
+
+enum MapType {
+    MAP_MUTEX = 0,
+    MAP_RWLOCK = 1,
+    MAP_STRIPED = 2,
+    MAP_FLAT = 3,
+    MAP_EPOCH = 4,
+    MAP_SEQLOCK = 5,
+    MAP_RESIZE = 6
+};
+
 struct ThreadArgs {
     int thread_id;
     int total_ops;
-    int read_percentage;  // 0-100
     double* execution_time;
     void* map;
-    int map_type;  // 0=mutex, 1=rwlock
+    int map_type;  // MapType
+    const WorkOp* ops;       // total_ops operaciones precalculadas
+    NodeArena<Node>* arena;  // No nula: insertar con una NodeCache por hilo
+};
+
+struct MapTotals {
+    long reads = 0;
+    long writes = 0;
+    long collisions = 0;
 };
 
+// Registro por hilo de las variantes con estado por hilo
+void map_attach(ThreadArgs* args) {
+    if (args->map_type == MAP_EPOCH) {
+        epoch_attach(&static_cast<HashMapEpoch*>(args->map)->epoch, args->thread_id);
+    } else if (args->map_type == MAP_SEQLOCK) {
+        map_attach_seqlock(static_cast<HashMapSeqlock*>(args->map), args->thread_id);
+    }
+}
+
+int map_get(ThreadArgs* args, int key) {
+    switch (args->map_type) {
+        case MAP_MUTEX:
+            return map_get_mutex(static_cast<HashMapMutex*>(args->map), key);
+        case MAP_RWLOCK:
+            return map_get_rwlock(static_cast<HashMapRWLock*>(args->map), key);
+        case MAP_FLAT:
+            return map_get_flat(static_cast<HashMapFlat*>(args->map), key);
+        case MAP_EPOCH:
+            return map_get_epoch(static_cast<HashMapEpoch*>(args->map), key);
+        case MAP_SEQLOCK:
+            return map_get_seqlock(static_cast<HashMapSeqlock*>(args->map), key);
+        case MAP_RESIZE:
+            return map_get_resizable(static_cast<HashMapResizable*>(args->map), key);
+        default:
+            return map_get_striped(static_cast<HashMapStriped*>(args->map), key);
+    }
+}
+
+void map_put(ThreadArgs* args, int key, int value, NodeCache<Node>* cache) {
+    switch (args->map_type) {
+        case MAP_MUTEX:
+            map_put_mutex(static_cast<HashMapMutex*>(args->map), key, value, cache);
+            break;
+        case MAP_RWLOCK:
+            map_put_rwlock(static_cast<HashMapRWLock*>(args->map), key, value, cache);
+            break;
+        case MAP_FLAT:
+            map_put_flat(static_cast<HashMapFlat*>(args->map), key, value);
+            break;
+        case MAP_EPOCH:
+            map_put_epoch(static_cast<HashMapEpoch*>(args->map), key, value);
+            break;
+        case MAP_SEQLOCK:
+            map_put_seqlock(static_cast<HashMapSeqlock*>(args->map), key, value);
+            break;
+        case MAP_RESIZE:
+            map_put_resizable(static_cast<HashMapResizable*>(args->map), key, value);
+            break;
+        default:
+            map_put_striped(static_cast<HashMapStriped*>(args->map), key, value, cache);
+            break;
+    }
+}
+
+bool map_remove(ThreadArgs* args, int key, NodeCache<Node>* cache) {
+    switch (args->map_type) {
+        case MAP_MUTEX:
+            return map_remove_mutex(static_cast<HashMapMutex*>(args->map), key, cache);
+        case MAP_RWLOCK:
+            return map_remove_rwlock(static_cast<HashMapRWLock*>(args->map), key, cache);
+        case MAP_FLAT:
+            return map_remove_flat(static_cast<HashMapFlat*>(args->map), key);
+        case MAP_EPOCH:
+            return map_remove_epoch(static_cast<HashMapEpoch*>(args->map), key);
+        case MAP_SEQLOCK:
+            return map_remove_seqlock(static_cast<HashMapSeqlock*>(args->map), key);
+        case MAP_RESIZE:
+            return map_remove_resizable(static_cast<HashMapResizable*>(args->map), key);
+        default:
+            return map_remove_striped(static_cast<HashMapStriped*>(args->map), key, cache);
+    }
+}
+
 void* worker_thread(void* arg) {
     auto* args = static_cast<ThreadArgs*>(arg);
     int id = args->thread_id;
     int ops = args->total_ops;
-    int read_pct = args->read_percentage;
+    map_attach(args);
     
-    // Seed para números aleatorios por hilo
-    unsigned int seed = id * 12345;
+    // Lista libre local de nodos (solo si la tabla usa arena)
+    NodeCache<Node> local_nodes(args->arena);
+    NodeCache<Node>* cache = args->arena ? &local_nodes : nullptr;
     
     double start = now_s();
     
     for (int i = 0; i < ops; i++) {
-        int key = rand_r(&seed) % 10000;  // Rango de claves
-        int operation = rand_r(&seed) % 100;
+        const WorkOp& op = args->ops[i];
         
-        if (operation < read_pct) {
-            // Operación de lectura
-            if (args->map_type == 0) {
-                map_get_mutex(static_cast<HashMapMutex*>(args->map), key);
-            } else {
-                map_get_rwlock(static_cast<HashMapRWLock*>(args->map), key);
-            }
-        } else {
-            // Operación de escritura
-            int value = id * 1000000 + i;
-            if (args->map_type == 0) {
-                map_put_mutex(static_cast<HashMapMutex*>(args->map), key, value);
-            } else {
-                map_put_rwlock(static_cast<HashMapRWLock*>(args->map), key, value);
-            }
+        switch (op.type) {
+            case OP_READ:
+                map_get(args, op.key);
+                break;
+            case OP_UPDATE:
+            case OP_INSERT:
+                map_put(args, op.key, id * 1000000 + i, cache);
+                break;
+            case OP_REMOVE:
+                map_remove(args, op.key, cache);
+                break;
         }
         
         // Simular algo de trabajo
@@ -242,32 +1197,154 @@ void* worker_thread(void* arg) {
     return nullptr;
 }
 
-void run_benchmark(const char* name, int map_type, int threads, 
-                   int ops_per_thread, int read_percentage) {
+struct BenchConfig {
+    int stripes = DEFAULT_STRIPES;
+    int key_range = KEY_RANGE;
+    int remove_pct = DEFAULT_REMOVE_PCT;
+    bool pooled = false;    // Nodos desde arena + NodeCache por hilo (tablas encadenadas)
+    const OpMix* mix = nullptr;    // nullptr: lecturas según read_percentage + remove_pct
+    KeyDist dist = DIST_UNIFORM;
+    double theta = DEFAULT_ZIPF_THETA;
+    bool preload = false;   // Insertar todo el espacio de claves antes de medir
+};
+
+// Mezcla clásica de P3: read_pct lecturas; de las escrituras, remove_pct son borrados
+OpMix classic_mix(int read_pct, int remove_pct) {
+    int writes = 100 - read_pct;
+    int removes = writes * remove_pct / 100;
+    return {"R/W", read_pct, writes - removes, 0, removes};
+}
+
+// zeta(n) cuesta O(n): se reutiliza mientras no cambien n ni θ
+const ZipfParams& zipf_params(uint32_t n, double theta) {
+    static ZipfParams cached;
+    if (cached.n != n || cached.theta != theta) {
+        cached = ZipfParams(n, theta);
+    }
+    return cached;
+}
+
+// Retorna el throughput (ops/segundo)
+double run_benchmark(const char* name, int map_type, int threads, 
+                     int ops_per_thread, int read_percentage, const BenchConfig& cfg = BenchConfig()) {
     printf("\n=== %s (R/W: %d/%d%%) ===\n", name, read_percentage, 100 - read_percentage);
     
+    // FLAT tiene capacidad fija: con más claves rechazaría inserciones y no
+    // sería comparable con las tablas encadenadas
+    if (map_type == MAP_FLAT && cfg.key_range > HashMapFlat::MAX_SIZE) {
+        printf("Omitida: %d claves superan la capacidad de FLAT (%d de %d slots)\n",
+               cfg.key_range, HashMapFlat::MAX_SIZE, FLAT_CAPACITY);
+        return 0;
+    }
+    
     void* map;
     HashMapMutex* mutex_map = nullptr;
     HashMapRWLock* rwlock_map = nullptr;
+    HashMapStriped* striped_map = nullptr;
+    HashMapFlat* flat_map = nullptr;
+    HashMapEpoch* epoch_map = nullptr;
+    HashMapSeqlock* seqlock_map = nullptr;
+    HashMapResizable* resize_map = nullptr;
+    
+    NodeArena<Node>* arena = nullptr;
     
-    if (map_type == 0) {
-        mutex_map = new HashMapMutex();
+    if (map_type == MAP_MUTEX) {
+        mutex_map = new HashMapMutex(cfg.pooled);
         map = mutex_map;
-    } else {
-        rwlock_map = new HashMapRWLock();
+        arena = &mutex_map->arena;
+    } else if (map_type == MAP_RWLOCK) {
+        rwlock_map = new HashMapRWLock(cfg.pooled);
         map = rwlock_map;
+        arena = &rwlock_map->arena;
+    } else if (map_type == MAP_FLAT) {
+        flat_map = new HashMapFlat();
+        map = flat_map;
+    } else if (map_type == MAP_EPOCH) {
+        epoch_map = new HashMapEpoch(threads, cfg.stripes);
+        map = epoch_map;
+    } else if (map_type == MAP_SEQLOCK) {
+        seqlock_map = new HashMapSeqlock(threads);
+        map = seqlock_map;
+    } else if (map_type == MAP_RESIZE) {
+        resize_map = new HashMapResizable();
+        map = resize_map;
+    } else {
+        striped_map = new HashMapStriped(cfg.stripes, cfg.pooled);
+        map = striped_map;
+        arena = &striped_map->arena;
+    }
+    if (!cfg.pooled) arena = nullptr;
+    
+    // Contadores acumulados de la tabla (sin hilos operando)
+    auto map_totals = [&]() {
+        MapTotals t;
+        if (map_type == MAP_MUTEX) {
+            t.reads = mutex_map->reads;
+            t.writes = mutex_map->writes;
+            t.collisions = mutex_map->collisions;
+        } else if (map_type == MAP_RWLOCK) {
+            t.reads = rwlock_map->reads;
+            t.writes = rwlock_map->writes;
+            t.collisions = rwlock_map->collisions;
+        } else if (map_type == MAP_FLAT) {
+            t.reads = flat_map->reads;
+            t.writes = flat_map->writes;
+            t.collisions = flat_map->collisions;
+        } else if (map_type == MAP_EPOCH) {
+            t.reads = epoch_map->reads();
+            t.writes = epoch_map->writes();
+            t.collisions = epoch_map->collisions();
+        } else if (map_type == MAP_SEQLOCK) {
+            t.reads = seqlock_map->total(&HashMapSeqlock::ThreadStats::reads);
+            t.writes = seqlock_map->total(&HashMapSeqlock::ThreadStats::writes);
+            t.collisions = seqlock_map->total(&HashMapSeqlock::ThreadStats::collisions);
+        } else if (map_type == MAP_RESIZE) {
+            t.reads = resize_map->reads;
+            t.writes = resize_map->writes;
+            t.collisions = resize_map->collisions;
+        } else {
+            t.reads = striped_map->reads();
+            t.writes = striped_map->writes();
+            t.collisions = striped_map->collisions();
+        }
+        return t;
+    };
+    
+    // Secuencias de operaciones de cada hilo, generadas antes de medir
+    WorkloadSpec spec;
+    spec.mix = cfg.mix ? *cfg.mix : classic_mix(read_percentage, cfg.remove_pct);
+    spec.dist = cfg.dist;
+    spec.key_range = static_cast<uint32_t>(cfg.key_range);
+    if (cfg.dist == DIST_ZIPFIAN || cfg.dist == DIST_LATEST) {
+        spec.zipf = &zipf_params(spec.key_range, cfg.theta);
+    }
+    std::vector<std::vector<WorkOp>> streams(threads);
+    for (int i = 0; i < threads; i++) {
+        streams[i] = make_op_stream(spec, i, threads, ops_per_thread);
+    }
+    
+    // Carga inicial (YCSB): todas las claves del espacio antes de medir
+    if (cfg.preload) {
+        ThreadArgs loader = {0, 0, nullptr, map, map_type, nullptr, arena};
+        map_attach(&loader);
+        NodeCache<Node> local_nodes(arena);
+        for (int key = 0; key < cfg.key_range; key++) {
+            map_put(&loader, key, key, arena ? &local_nodes : nullptr);
+        }
     }
+    MapTotals loaded = map_totals();
     
     std::vector<pthread_t> thread_handles(threads);
     std::vector<ThreadArgs> thread_args(threads);
     std::vector<double> execution_times(threads);
     
+    PerfScope perf;  // Solo activo con LAB6_PERF=1
     double start_time = now_s();
     
     // Crear hilos
     for (int i = 0; i < threads; i++) {
-        thread_args[i] = {i, ops_per_thread, read_percentage, 
-                         execution_times.data(), map, map_type};
+        thread_args[i] = {i, ops_per_thread, execution_times.data(), map, map_type,
+                          streams[i].data(), arena};
         pthread_create(&thread_handles[i], nullptr, worker_thread, &thread_args[i]);
     }
     
@@ -277,23 +1354,22 @@ void run_benchmark(const char* name, int map_type, int threads,
     }
     
     double total_time = now_s() - start_time;
+    perf.stop();
     
-    // Recopilar estadísticas
-    long total_reads, total_writes, total_collisions;
-    if (map_type == 0) {
-        total_reads = mutex_map->reads;
-        total_writes = mutex_map->writes;
-        total_collisions = mutex_map->collisions;
-    } else {
-        total_reads = rwlock_map->reads;
-        total_writes = rwlock_map->writes;
-        total_collisions = rwlock_map->collisions;
-    }
+    // Recopilar estadísticas (descontando la carga inicial)
+    MapTotals after = map_totals();
+    long total_reads = after.reads - loaded.reads;
+    long total_writes = after.writes - loaded.writes;
+    long total_collisions = after.collisions - loaded.collisions;
     
     long total_ops = total_reads + total_writes;
     double throughput = total_ops / total_time;
     
     printf("Hilos: %d, Operaciones por hilo: %d\n", threads, ops_per_thread);
+    if (striped_map) {
+        printf("Franjas: %zu (%d buckets por franja)\n", striped_map->stripes.size(),
+               NBUCKET / static_cast<int>(striped_map->stripes.size()));
+    }
     printf("Tiempo total: %.4f segundos\n", total_time);
     printf("Lecturas: %ld, Escrituras: %ld\n", total_reads, total_writes);
     printf("Colisiones: %ld (%.2f%%)\n", total_collisions, 
@@ -307,28 +1383,313 @@ void run_benchmark(const char* name, int map_type, int threads,
     }
     avg_thread_time /= threads;
     printf("Tiempo promedio por hilo: %.4f segundos\n", avg_thread_time);
+    perf.print();
+    if (epoch_map) {
+        const auto& ep = epoch_map->epoch;
+        printf("Épocas: %ld avances, %ld nodos retirados, %ld liberados, %zu pendientes (máx %zu por hilo)\n",
+               ep.advances.load(), ep.retired_total(), ep.freed_total(), ep.pending(), ep.pending_peak());
+    }
+    if (flat_map) {
+        printf("Inserciones rechazadas (tabla llena): %ld\n", flat_map->rejected);
+    }
+    if (seqlock_map) {
+        long retries = seqlock_map->total(&HashMapSeqlock::ThreadStats::retries);
+        long in_place = seqlock_map->total(&HashMapSeqlock::ThreadStats::in_place);
+        printf("Reintentos de lectura: %ld (%.3f%% de las lecturas)\n", retries,
+               total_reads ? 100.0 * retries / total_reads : 0.0);
+        printf("Escrituras en el lugar (solo seqlock): %ld de %ld (%.1f%%)\n", in_place,
+               total_writes, total_writes ? 100.0 * in_place / total_writes : 0.0);
+    }
+    if (resize_map) {
+        printf("Buckets finales: %zu (%ld duplicaciones, %ld buckets migrados, de a %d por escritura)\n",
+               resize_map->cur.size(), resize_map->resizes, resize_map->migrated, RESIZE_STEP);
+        printf("Claves: %ld, carga: %.2f por bucket%s\n", resize_map->count,
+               static_cast<double>(resize_map->count) / resize_map->cur.size(),
+               resize_map->old.buckets ? " (migración en curso)" : "");
+    }
+    if (arena) {
+        printf("Arena: %zu bloques (%.1f KB), %ld rellenos de caché\n", arena->chunks.size(),
+               arena->bytes() / 1024.0, arena->refills);
+    }
     
-    // Cleanup
-    if (map_type == 0) {
-        delete mutex_map;
-    } else {
-        delete rwlock_map;
+    // Cleanup (medido: con arena es liberar bloques, sin ella un delete por nodo)
+    double free_start = now_s();
+    delete mutex_map;
+    delete rwlock_map;
+    delete striped_map;
+    delete flat_map;
+    delete epoch_map;
+    delete seqlock_map;
+    delete resize_map;
+    printf("Liberación de la tabla: %.3f ms\n", (now_s() - free_start) * 1e3);
+    return throughput;
+}
+
+// Bytes ocupados por una tabla encadenada: la estructura más cada nodo
+// según malloc (tamaño utilizable + cabecera)
+template <class Map>
+std::size_t chained_footprint(const Map* map) {
+    std::size_t bytes = sizeof(*map);
+    for (int i = 0; i < NBUCKET; i++) {
+        for (Node* n = map->buckets[i]; n; n = n->next) {
+            bytes += malloc_usable_size(n) + sizeof(std::size_t);
+        }
     }
+    return bytes;
+}
+
+// ns por búsqueda con un hilo; claves precalculadas para no medir el PRNG
+template <class Map, class Get>
+double lookup_ns(Map* map, Get get, const std::vector<int>& keys) {
+    long found = 0;
+    double start = now_s();
+    for (int key : keys) {
+        found += get(map, key) >= 0;
+    }
+    double elapsed = now_s() - start;
+    if (found < 0) printf("?");  // Evita que el compilador descarte las búsquedas
+    return elapsed * 1e9 / keys.size();
+}
+
+/**
+ * Búsquedas de un solo hilo sobre tablas con KEY_RANGE claves:
+ * ns/op con aciertos y fallos, y memoria ocupada por cada tabla.
+ * Comprueba además que el borrado sin lápidas de FLAT no pierde claves.
+ */
+void run_lookup_suite() {
+    printf("\n=== BÚSQUEDAS: %d claves, %d búsquedas por medición ===\n", KEY_RANGE, LOOKUP_OPS);
+    
+    unsigned int seed = 4242;
+    std::vector<int> hits(LOOKUP_OPS), misses(LOOKUP_OPS);
+    for (int i = 0; i < LOOKUP_OPS; i++) {
+        hits[i] = rand_r(&seed) % KEY_RANGE;
+        misses[i] = KEY_RANGE + rand_r(&seed) % KEY_RANGE;
+    }
+    
+    auto* mutex_map = new HashMapMutex();
+    auto* rwlock_map = new HashMapRWLock();
+    auto* flat_map = new HashMapFlat();
+    for (int key = 0; key < KEY_RANGE; key++) {
+        map_put_mutex(mutex_map, key, key);
+        map_put_rwlock(rwlock_map, key, key);
+        map_put_flat(flat_map, key, key);
+    }
+    
+    printf("%-8s %14s %14s %14s\n", "Tabla", "acierto ns/op", "fallo ns/op", "memoria KB");
+    printf("%-8s %14.1f %14.1f %14.1f\n", "MUTEX",
+           lookup_ns(mutex_map, map_get_mutex, hits),
+           lookup_ns(mutex_map, map_get_mutex, misses),
+           chained_footprint(mutex_map) / 1024.0);
+    printf("%-8s %14.1f %14.1f %14.1f\n", "RWLOCK",
+           lookup_ns(rwlock_map, map_get_rwlock, hits),
+           lookup_ns(rwlock_map, map_get_rwlock, misses),
+           chained_footprint(rwlock_map) / 1024.0);
+    printf("%-8s %14.1f %14.1f %14.1f\n", "FLAT",
+           lookup_ns(flat_map, map_get_flat, hits),
+           lookup_ns(flat_map, map_get_flat, misses),
+           sizeof(*flat_map) / 1024.0);
+    printf("Ocupación FLAT: %d/%d (%.0f%%), inserciones fuera de casa: %ld\n",
+           flat_map->size, FLAT_CAPACITY, 100.0 * flat_map->size / FLAT_CAPACITY,
+           flat_map->collisions);
+    
+    // Borrado sin lápidas: llenar otra tabla hasta 7/8 con claves aleatorias
+    // (muchos grupos largos), borrar la mitad y verificar las demás
+    auto* check_map = new HashMapFlat();
+    std::vector<int> inserted;
+    while (check_map->size < HashMapFlat::MAX_SIZE) {
+        int key = rand_r(&seed) & 0x3fffffff;
+        int before = check_map->size;
+        map_put_flat(check_map, key, key ^ 0x5555);
+        if (check_map->size > before) inserted.push_back(key);
+    }
+    long displaced = check_map->collisions;
+    bool ok = true;
+    for (std::size_t i = 1; i < inserted.size(); i += 2) {
+        ok = map_remove_flat(check_map, inserted[i]) && ok;
+    }
+    for (std::size_t i = 0; i < inserted.size(); i++) {
+        int expected = (i % 2 == 0) ? (inserted[i] ^ 0x5555) : -1;
+        ok = ok && map_get_flat(check_map, inserted[i]) == expected;
+    }
+    printf("Borrado sin lápidas (%d claves al 87%%, %ld fuera de casa, se borra la mitad): %s\n",
+           HashMapFlat::MAX_SIZE, displaced, ok ? "CORRECTO" : "INCORRECTO");
+    delete check_map;
+    
+    delete mutex_map;
+    delete rwlock_map;
+    delete flat_map;
+}
+
+/**
+ * Mezclas YCSB seleccionadas (letras de `mixes`) con cada distribución de
+ * claves, sobre MUTEX y RWLOCK con la tabla precargada. Al final de cada
+ * mezcla imprime el throughput por distribución y tabla.
+ */
+void run_ycsb_suite(const char* mixes, int threads, int ops_per_thread, const BenchConfig& base) {
+    for (const char* m = mixes; *m; m++) {
+        const OpMix* mix = ycsb_mix(*m);
+        double throughput[DIST_COUNT][2];
+        
+        for (int d = 0; d < DIST_COUNT; d++) {
+            BenchConfig cfg = base;
+            cfg.mix = mix;
+            cfg.dist = static_cast<KeyDist>(d);
+            cfg.preload = true;
+            
+            char name[96];
+            snprintf(name, sizeof(name), "%s %s MUTEX", mix->name, key_dist_name(cfg.dist));
+            throughput[d][0] = run_benchmark(name, MAP_MUTEX, threads, ops_per_thread, mix->read, cfg);
+            snprintf(name, sizeof(name), "%s %s RWLOCK", mix->name, key_dist_name(cfg.dist));
+            throughput[d][1] = run_benchmark(name, MAP_RWLOCK, threads, ops_per_thread, mix->read, cfg);
+        }
+        
+        printf("\n=== RESUMEN %s (lectura %d%%, actualización %d%%, inserción %d%%; %d claves, θ=%.2f) ===\n",
+               mix->name, mix->read, mix->update, mix->insert, base.key_range, base.theta);
+        printf("%-12s %16s %16s\n", "Distribución", "MUTEX ops/s", "RWLOCK ops/s");
+        for (int d = 0; d < DIST_COUNT; d++) {
+            printf("%-12s %16.0f %16.0f\n", key_dist_name(static_cast<KeyDist>(d)),
+                   throughput[d][0], throughput[d][1]);
+        }
+    }
+}
+
+void usage(const char* prog) {
+    fprintf(stderr, "Uso: %s [hilos] [operaciones_por_hilo] [-s franjas] [-d borrados] [-k claves] [-w abcd] [-z theta]\n", prog);
+    fprintf(stderr, "  -s franjas: candados de STRIPED y EPOCH (1..%d, por defecto %d)\n",
+            NBUCKET, DEFAULT_STRIPES);
+    fprintf(stderr, "  -d borrados: %% de las escrituras que son borrados (por defecto %d)\n",
+            DEFAULT_REMOVE_PCT);
+    fprintf(stderr, "  -k claves: tamaño del espacio de claves (por defecto %d)\n", KEY_RANGE);
+    fprintf(stderr, "  -w abcd: correr las mezclas YCSB indicadas en lugar del barrido R/W\n");
+    fprintf(stderr, "  -z theta: exponente de zipf en (0, 1) (por defecto %.2f)\n", DEFAULT_ZIPF_THETA);
 }
 
 int main(int argc, char** argv) {
-    int threads = (argc > 1) ? std::atoi(argv[1]) : 4;
-    int ops_per_thread = (argc > 2) ? std::atoi(argv[2]) : 50000;
+    int stripes = DEFAULT_STRIPES;
+    int remove_pct = DEFAULT_REMOVE_PCT;
+    int key_range = KEY_RANGE;
+    const char* ycsb = nullptr;
+    double theta = DEFAULT_ZIPF_THETA;
+    int opt;
+    while ((opt = getopt(argc, argv, "s:d:k:w:z:h")) != -1) {
+        switch (opt) {
+            case 's':
+                stripes = std::atoi(optarg);
+                if (stripes < 1 || stripes > NBUCKET) {
+                    fprintf(stderr, "-s debe estar entre 1 y %d\n", NBUCKET);
+                    return 1;
+                }
+                break;
+            case 'd':
+                remove_pct = std::atoi(optarg);
+                if (remove_pct < 0 || remove_pct > 100) {
+                    fprintf(stderr, "-d debe estar entre 0 y 100\n");
+                    return 1;
+                }
+                break;
+            case 'k':
+                key_range = std::atoi(optarg);
+                if (key_range < 1) {
+                    fprintf(stderr, "-k debe ser positivo\n");
+                    return 1;
+                }
+                break;
+            case 'w':
+                ycsb = optarg;
+                for (const char* m = ycsb; *m; m++) {
+                    if (!ycsb_mix(*m)) {
+                        fprintf(stderr, "-w: mezcla YCSB desconocida '%c' (usar a, b, c o d)\n", *m);
+                        return 1;
+                    }
+                }
+                break;
+            case 'z':
+                theta = std::atof(optarg);
+                if (!(theta > 0 && theta < 1)) {
+                    fprintf(stderr, "-z debe estar en (0, 1)\n");
+                    return 1;
+                }
+                break;
+            default:
+                usage(argv[0]);
+                return 1;
+        }
+    }
+    
+    // Argumentos posicionales (getopt los deja al final)
+    int npos = argc - optind;
+    char** pos = argv + optind;
+    int threads = (npos > 0) ? std::atoi(pos[0]) : 4;
+    int ops_per_thread = (npos > 1) ? std::atoi(pos[1]) : 50000;
     
     printf("Laboratorio 6 - Práctica 3: Lectores/Escritores\n");
     printf("Configuración: %d hilos, %d operaciones por hilo\n", threads, ops_per_thread);
+    printf("Espacio de claves: %d\n", key_range);
+    
+    BenchConfig sweep_cfg;
+    sweep_cfg.stripes = stripes;
+    sweep_cfg.remove_pct = remove_pct;
+    sweep_cfg.key_range = key_range;
+    sweep_cfg.theta = theta;
+    
+    if (ycsb) {
+        printf("Mezclas YCSB: %s, zipf θ=%.2f\n", ycsb, theta);
+        run_ycsb_suite(ycsb, threads, ops_per_thread, sweep_cfg);
+        return 0;
+    }
+    printf("Borrados: %d%% de las escrituras\n", remove_pct);
     
     // Probar diferentes proporciones de lectura/escritura
     std::vector<int> read_percentages = {90, 70, 50, 30, 10};
     
     for (int read_pct : read_percentages) {
-        run_benchmark("MUTEX", 0, threads, ops_per_thread, read_pct);
-        run_benchmark("RWLOCK", 1, threads, ops_per_thread, read_pct);
+        run_benchmark("MUTEX", MAP_MUTEX, threads, ops_per_thread, read_pct, sweep_cfg);
+        run_benchmark("RWLOCK", MAP_RWLOCK, threads, ops_per_thread, read_pct, sweep_cfg);
+        run_benchmark("STRIPED", MAP_STRIPED, threads, ops_per_thread, read_pct, sweep_cfg);
+        run_benchmark("FLAT", MAP_FLAT, threads, ops_per_thread, read_pct, sweep_cfg);
+        run_benchmark("EPOCH", MAP_EPOCH, threads, ops_per_thread, read_pct, sweep_cfg);
+        run_benchmark("SEQLOCK", MAP_SEQLOCK, threads, ops_per_thread, read_pct, sweep_cfg);
+    }
+    
+    // Sin borrados nada se retira: una corrida EPOCH con borrados para ver la recuperación
+    if (remove_pct == 0) {
+        BenchConfig epoch_cfg = sweep_cfg;
+        epoch_cfg.remove_pct = EPOCH_REMOVE_PCT;
+        printf("\n=== RECUPERACIÓN POR ÉPOCAS (%d%% de las escrituras son borrados) ===\n",
+               EPOCH_REMOVE_PCT);
+        run_benchmark("EPOCH con borrados", MAP_EPOCH, threads, ops_per_thread, 70, epoch_cfg);
+    }
+    
+    run_lookup_suite();
+    
+    // Asignación de nodos: new/delete contra arena, con mayoría de inserciones
+    printf("\n=== ASIGNACIÓN DE NODOS: new/delete vs arena (%d claves, solo escrituras) ===\n",
+           ALLOC_KEY_RANGE);
+    BenchConfig alloc_new;
+    alloc_new.key_range = ALLOC_KEY_RANGE;
+    BenchConfig alloc_arena = alloc_new;
+    alloc_arena.pooled = true;
+    run_benchmark("MUTEX new", MAP_MUTEX, threads, ops_per_thread, 0, alloc_new);
+    run_benchmark("MUTEX arena", MAP_MUTEX, threads, ops_per_thread, 0, alloc_arena);
+    run_benchmark("RWLOCK new", MAP_RWLOCK, threads, ops_per_thread, 0, alloc_new);
+    run_benchmark("RWLOCK arena", MAP_RWLOCK, threads, ops_per_thread, 0, alloc_arena);
+    
+    // Tabla fija (NBUCKET) contra redimensionable al crecer el espacio de claves
+    printf("\n=== REDIMENSIONAMIENTO: tabla fija vs incremental (R/W: 50/50%%) ===\n");
+    for (int key_range : {10000, 100000, 1000000, 10000000}) {
+        BenchConfig range_cfg = sweep_cfg;
+        range_cfg.key_range = key_range;
+        range_cfg.preload = true;   // La tabla llega a key_range claves antes de medir
+        char name[64];
+        if (key_range <= RESIZE_FIXED_MAX_KEYS) {
+            snprintf(name, sizeof(name), "RWLOCK fija, %d claves", key_range);
+            run_benchmark(name, MAP_RWLOCK, threads, ops_per_thread, 50, range_cfg);
+        } else {
+            printf("\n(RWLOCK fija omitida con %d claves: cadenas de ~%d nodos,\n"
+                   " la carga inicial sola tarda O(n^2/NBUCKET))\n", key_range, key_range / NBUCKET);
+        }
+        snprintf(name, sizeof(name), "RESIZE, %d claves", key_range);
+        run_benchmark(name, MAP_RESIZE, threads, ops_per_thread, 50, range_cfg);
     }
     
     printf("\n=== ANÁLISIS ===\n");
@@ -336,6 +1697,19 @@ int main(int argc, char** argv) {
     printf("- RWLOCK: Permite múltiples lectores concurrentes\n");
     printf("- RWLock es más eficiente cuando hay mayoría de lecturas (≥70%%)\n");
     printf("- Con muchas escrituras, el overhead de rwlock puede ser contraproducente\n");
+    printf("- STRIPED: escrituras a franjas distintas no se bloquean entre sí; gana\n");
+    printf("  sobre todo con mayoría de escrituras, donde un solo candado serializa todo\n");
+    printf("- FLAT: claves contiguas y sin nodos; búsquedas con menos fallos de caché\n");
+    printf("  y sin reservas de memoria al insertar\n");
+    printf("- Arena: el nodo se toma de una lista libre local antes del candado\n");
+    printf("  (menos tiempo con el candado tomado) y la tabla se libera de una vez\n");
+    printf("- EPOCH: los lectores no escriben memoria compartida; ideal con mayoría\n");
+    printf("  de lecturas. Los nodos borrados esperan dos épocas antes de liberarse;\n");
+    printf("  sin -d solo la corrida \"EPOCH con borrados\" retira nodos\n");
+    printf("- SEQLOCK: actualizar un valor solo toma el seqlock del bucket; los lectores\n");
+    printf("  reintentan si la secuencia cambió (ver tasa de reintentos)\n");
+    printf("- RESIZE: con la tabla fija las cadenas crecen con el espacio de claves;\n");
+    printf("  duplicar de a poco mantiene la carga acotada sin pausas de rehash\n");
     
     return 0;
 }
\ No newline at end of file
@@ -14,6 +14,7 @@
 #include <unistd.h>
 #include <cstring>
 #include "../include/timing.hpp"
+#include "../include/perf_counters.hpp"
 
 constexpr int TICKS = 1000;
 constexpr int BUFFER_SIZE = 100;
@@ -77,6 +78,7 @@ void* stage_generator(void* arg) {
     // Inicialización única
     pthread_once(&once_flag, init_shared_resources);
     
+    PerfScope perf(false);  // Solo este hilo; activo con LAB6_PERF=1
     double stage_start = now_s();
     
     for (int tick = 0; tick < TICKS && !pipeline_shutdown; tick++) {
@@ -121,6 +123,7 @@ void* stage_generator(void* arg) {
     double stage_end = now_s();
     printf("[STAGE %ld] Generador terminado en %.4f segundos\n", 
            stage_id, stage_end - stage_start);
+    perf.print("[GEN] Perf");
     
     return nullptr;
 }
@@ -136,6 +139,7 @@ void* stage_filter(void* arg) {
     // Inicialización única
     pthread_once(&once_flag, init_shared_resources);
     
+    PerfScope perf(false);  // Solo este hilo; activo con LAB6_PERF=1
     double stage_start = now_s();
     
     for (int tick = 0; tick < TICKS && !pipeline_shutdown; tick++) {
@@ -183,6 +187,7 @@ void* stage_filter(void* arg) {
     double stage_end = now_s();
     printf("[STAGE %ld] Filtro terminado en %.4f segundos\n", 
            stage_id, stage_end - stage_start);
+    perf.print("[FILTER] Perf");
     
     return nullptr;
 }
@@ -198,6 +203,7 @@ void* stage_reducer(void* arg) {
     // Inicialización única
     pthread_once(&once_flag, init_shared_resources);
     
+    PerfScope perf(false);  // Solo este hilo; activo con LAB6_PERF=1
     double stage_start = now_s();
     long accumulated_sum = 0;
     
@@ -248,6 +254,7 @@ void* stage_reducer(void* arg) {
     double stage_end = now_s();
     printf("[STAGE %ld] Reducer terminado en %.4f segundos\n", 
            stage_id, stage_end - stage_start);
+    perf.print("[REDUCE] Perf");
     printf("[REDUCE] Suma total acumulada: %ld\n", accumulated_sum);
     
     return nullptr;